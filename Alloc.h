@@ -25,7 +25,7 @@ class simple_alloc {
 class malloc_alloc {
    public:
     static void* allocate(size_t n) { return malloc(n); }
-    static void* deallocate(void* p, size_t) { free(p); }
+    static void deallocate(void* p, size_t) { free(p); }
     static void* reallocate(void* p, size_t, size_t new_sz) {
         return realloc(p, new_sz);
     }
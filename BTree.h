@@ -0,0 +1,692 @@
+#ifndef BTREE_H__
+#define BTREE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Function.h"
+#include "Iterator.h"
+
+namespace TinySTL {
+
+// B树节点，叶子节点只有值，内部节点在后面多出count+1个子节点指针
+//值放在未初始化的存储里，只有[0, count)是构造过的
+template <class Value, int N>
+struct __btree_node {
+    typedef __btree_node* node_ptr;
+
+    node_ptr parent;
+    unsigned short position;  //在父节点children中的下标
+    unsigned short count;     //值的个数
+    bool leaf;
+    alignas(Value) char storage[N * sizeof(Value)];
+
+    Value* value(int i) { return (Value*)storage + i; }
+    node_ptr& child(int i);
+    //挂上子节点并维护它的parent和position
+    void set_child(int i, node_ptr c) {
+        child(i) = c;
+        c->parent = this;
+        c->position = i;
+    }
+};
+
+template <class Value, int N>
+struct __btree_internal_node : public __btree_node<Value, N> {
+    __btree_node<Value, N>* children[N + 1];
+};
+
+template <class Value, int N>
+inline __btree_node<Value, N>*& __btree_node<Value, N>::child(int i) {
+    return ((__btree_internal_node<Value, N>*)this)->children[i];
+}
+
+//迭代器是(节点, 下标)，end()是(root, root->count)
+//插入删除会在节点间搬动元素，所有迭代器都会失效
+template <class Value, class Ref, class Ptr, int N>
+struct __btree_iterator {
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef Ref reference;
+    typedef Ptr pointer;
+    typedef ptrdiff_t difference_type;
+    typedef __btree_iterator<Value, Value&, Value*, N> iterator;
+    typedef __btree_iterator<Value, const Value&, const Value*, N>
+        const_iterator;
+    typedef __btree_iterator<Value, Ref, Ptr, N> self;
+    typedef __btree_node<Value, N>* node_ptr;
+
+    node_ptr node;
+    int position;
+
+    __btree_iterator() : node(0), position(0) {}
+    __btree_iterator(node_ptr x, int i) : node(x), position(i) {}
+    __btree_iterator(const iterator& it)
+        : node(it.node), position(it.position) {}
+
+    reference operator*() const { return *node->value(position); }
+    pointer operator->() const { return &(operator*()); }
+
+    //内部节点的后继是右子树最左的叶子，叶子走完了往上找第一个还没走完的祖先
+    void increment() {
+        if (!node->leaf) {
+            node = node->child(position + 1);
+            while (!node->leaf) node = node->child(0);
+            position = 0;
+        } else if (++position == node->count) {
+            while (node->parent && position == node->count) {
+                position = node->position;
+                node = node->parent;
+            }
+        }
+    }
+    void decrement() {
+        if (!node->leaf) {
+            node = node->child(position);
+            while (!node->leaf) node = node->child(node->count);
+            position = node->count - 1;
+        } else if (position > 0)
+            --position;
+        else {
+            while (node->position == 0) node = node->parent;
+            position = node->position - 1;
+            node = node->parent;
+        }
+    }
+
+    self& operator++() {
+        increment();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        increment();
+        return tmp;
+    }
+    self& operator--() {
+        decrement();
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        decrement();
+        return tmp;
+    }
+    bool operator==(const const_iterator& x) const {
+        return node == x.node && position == x.position;
+    }
+    bool operator!=(const const_iterator& x) const { return !(*this == x); }
+};
+
+// B树，键唯一，是btree_map和btree_set的底层
+//每个节点约TargetNodeSize字节，放几十个值，查找时每层只有一两次缓存未命中，
+//节点内对算术类型的键线性计数（无分支，编译器可以向量化），其他键二分查找
+template <class Key, class Value, class KeyOfValue, class Compare,
+          class Alloc = alloc, int TargetNodeSize = 256>
+class btree {
+   public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    enum {
+        node_values =
+            (TargetNodeSize - 2 * sizeof(void*)) / sizeof(Value) > 3
+                ? (TargetNodeSize - 2 * sizeof(void*)) / sizeof(Value)
+                : 3,
+        min_values = node_values / 2  //非根节点删除后少于这个数就要调整
+    };
+
+    typedef __btree_iterator<value_type, reference, pointer, node_values>
+        iterator;
+    typedef __btree_iterator<value_type, const_reference, const_pointer,
+                             node_values>
+        const_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
+   protected:
+    typedef __btree_node<Value, node_values> node;
+    typedef __btree_internal_node<Value, node_values> internal_node;
+    typedef node* node_ptr;
+    typedef simple_alloc<node, Alloc> leaf_allocator;
+    typedef simple_alloc<internal_node, Alloc> internal_allocator;
+
+    node_ptr root;
+    size_type node_count;  //元素个数
+    Compare key_compare;
+
+    static node_ptr new_node(bool leaf) {
+        node_ptr x = leaf ? leaf_allocator::allocate()
+                          : (node_ptr)internal_allocator::allocate();
+        x->parent = 0;
+        x->position = 0;
+        x->count = 0;
+        x->leaf = leaf;
+        return x;
+    }
+    static void delete_node(node_ptr x) {
+        if (x->leaf)
+            leaf_allocator::deallocate(x);
+        else
+            internal_allocator::deallocate((internal_node*)x);
+    }
+    static const Key& key(node_ptr x, int i) {
+        return KeyOfValue()(*x->value(i));
+    }
+    //值在节点间搬动，pair<const K, T>不能赋值，只能重新构造；
+    //从原来的值移动构造，std::string等不再重新配置内存
+    static void move_value(node_ptr to, int j, node_ptr from, int i) {
+        construct(to->value(j), std::move(*from->value(i)));
+        destroy(from->value(i));
+    }
+
+    //节点内第一个不小于k的位置
+    int lower_in(node_ptr x, const Key& k) const {
+        return search_in(x, k, std::is_arithmetic<Key>());
+    }
+    int search_in(node_ptr x, const Key& k, std::true_type) const {
+        int n = 0;
+        for (int i = 0; i < x->count; ++i) n += key_compare(key(x, i), k);
+        return n;
+    }
+    int search_in(node_ptr x, const Key& k, std::false_type) const {
+        int lo = 0, hi = x->count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (key_compare(key(x, mid), k))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+    bool equal_at(node_ptr x, int i, const Key& k) const {
+        return i < x->count && !key_compare(k, key(x, i));
+    }
+
+    //叶子上的位置走到末尾时，真正的位置是第一个还没走完的祖先
+    static iterator fix_position(node_ptr x, int i) {
+        while (x->parent && i == x->count) {
+            i = x->position;
+            x = x->parent;
+        }
+        return iterator(x, i);
+    }
+
+    node_ptr copy_node(node_ptr x);
+    void destroy_node(node_ptr x);
+    void split(node_ptr& x, int& i);
+    iterator insert_at(iterator position, const value_type& v);
+    template <class Arg>
+    iterator insert_in_node(node_ptr x, int i, Arg&& v);
+    void rebalance_after_erase(node_ptr x);
+
+   public:
+    btree(const Compare& comp = Compare())
+        : root(0), node_count(0), key_compare(comp) {}
+    btree(const btree& x)
+        : root(0), node_count(x.node_count), key_compare(x.key_compare) {
+        if (x.root) root = copy_node(x.root);
+    }
+    ~btree() { clear(); }
+    btree& operator=(const btree& x) {
+        if (this != &x) {
+            clear();
+            key_compare = x.key_compare;
+            if (x.root) root = copy_node(x.root);
+            node_count = x.node_count;
+        }
+        return *this;
+    }
+
+   public:
+    // accessors:
+    Compare key_comp() const { return key_compare; }
+    iterator begin() {
+        if (!root) return end();
+        node_ptr x = root;
+        while (!x->leaf) x = x->child(0);
+        return iterator(x, 0);
+    }
+    const_iterator begin() const {
+        return const_cast<btree*>(this)->begin();
+    }
+    iterator end() { return iterator(root, root ? root->count : 0); }
+    const_iterator end() const {
+        return const_iterator(root, root ? root->count : 0);
+    }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+    bool empty() const { return node_count == 0; }
+    size_type size() const { return node_count; }
+    size_type max_size() const { return size_type(-1); }
+
+    void swap(btree& t) {
+        std::swap(root, t.root);
+        std::swap(node_count, t.node_count);
+        std::swap(key_compare, t.key_compare);
+    }
+
+   public:
+    // insert/erase
+    std::pair<iterator, bool> insert_unique(const value_type& v);
+    iterator insert_unique(iterator position, const value_type& v);
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) insert_unique(end(), *first);
+    }
+
+    void erase(iterator position);
+    size_type erase(const key_type& k);
+    void erase(iterator first, iterator last);
+    void clear() {
+        if (root) {
+            destroy_node(root);
+            root = 0;
+            node_count = 0;
+        }
+    }
+
+   public:
+    // set operations:
+    iterator find(const key_type& k);
+    const_iterator find(const key_type& k) const {
+        return const_cast<btree*>(this)->find(k);
+    }
+    size_type count(const key_type& k) const { return find(k) != end(); }
+    iterator lower_bound(const key_type& k);
+    const_iterator lower_bound(const key_type& k) const {
+        return const_cast<btree*>(this)->lower_bound(k);
+    }
+    iterator upper_bound(const key_type& k);
+    const_iterator upper_bound(const key_type& k) const {
+        return const_cast<btree*>(this)->upper_bound(k);
+    }
+    std::pair<iterator, iterator> equal_range(const key_type& k) {
+        return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& k) const {
+        return std::pair<const_iterator, const_iterator>(lower_bound(k),
+                                                         upper_bound(k));
+    }
+
+   public:
+    // Debugging.
+    bool __btree_verify() const;
+
+   private:
+    int __verify_node(node_ptr x, size_type& n) const;
+};
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          int TargetNodeSize>
+inline bool operator==(
+    const btree<Key, Value, KeyOfValue, Compare, Alloc, TargetNodeSize>& x,
+    const btree<Key, Value, KeyOfValue, Compare, Alloc, TargetNodeSize>& y) {
+    return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          int TargetNodeSize>
+inline bool operator<(
+    const btree<Key, Value, KeyOfValue, Compare, Alloc, TargetNodeSize>& x,
+    const btree<Key, Value, KeyOfValue, Compare, Alloc, TargetNodeSize>& y) {
+    return std::lexicographical_compare(x.begin(), x.end(), y.begin(),
+                                        y.end());
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::node_ptr
+btree<K, V, KoV, Cmp, Al, S>::copy_node(node_ptr x) {
+    node_ptr y = new_node(x->leaf);
+    int i = 0, c = 0;
+    try {
+        for (; i < x->count; ++i) construct(y->value(i), *x->value(i));
+        if (!x->leaf)
+            for (; c <= x->count; ++c) y->set_child(c, copy_node(x->child(c)));
+    }
+    catch (...) {
+        for (int j = 0; j < c; ++j) destroy_node(y->child(j));
+        for (int j = 0; j < i; ++j) destroy(y->value(j));
+        delete_node(y);
+        throw;
+    }
+    y->count = x->count;
+    return y;
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+void btree<K, V, KoV, Cmp, Al, S>::destroy_node(node_ptr x) {
+    for (int i = 0; i < x->count; ++i) destroy(x->value(i));
+    if (!x->leaf)
+        for (int i = 0; i <= x->count; ++i) destroy_node(x->child(i));
+    delete_node(x);
+}
+
+//把满节点x分成两个，中间的值上移到父节点，父节点满了先分裂父节点
+//i是x中要插入的位置，返回时x和i指向分裂后应该插入的节点和位置
+//在节点两端插入时把分裂点偏向另一端，顺序插入时节点几乎是满的
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+void btree<K, V, KoV, Cmp, Al, S>::split(node_ptr& x, int& i) {
+    node_ptr parent = x->parent;
+    if (parent == 0) {
+        parent = new_node(false);
+        parent->set_child(0, x);
+        root = parent;
+    } else if (parent->count == node_values) {
+        int pos = x->position;
+        split(parent, pos);  // x可能随之移到新的父节点
+        parent = x->parent;
+    }
+    node_ptr dest = new_node(x->leaf);
+    int moved = i == 0 ? node_values - 1
+                       : i == node_values ? 0 : node_values / 2;
+    int keep = node_values - moved - 1;
+    for (int j = 0; j < moved; ++j) move_value(dest, j, x, keep + 1 + j);
+    if (!x->leaf)
+        for (int j = 0; j <= moved; ++j)
+            dest->set_child(j, x->child(keep + 1 + j));
+    dest->count = moved;
+
+    //中间值和dest插到父节点x->position处
+    int p = x->position;
+    for (int j = parent->count; j > p; --j) {
+        move_value(parent, j, parent, j - 1);
+        parent->set_child(j + 1, parent->child(j));
+    }
+    move_value(parent, p, x, keep);
+    parent->set_child(p + 1, dest);
+    ++parent->count;
+    x->count = keep;
+
+    if (i > keep) {
+        i -= keep + 1;
+        x = dest;
+    }
+}
+
+//在position处插入v，调用者保证位置正确
+//内部节点的位置改为插在前驱之后，前驱总在叶子的末尾
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::insert_at(iterator position,
+                                        const value_type& v) {
+    if (root == 0) {
+        root = new_node(true);
+        try {
+            return insert_in_node(root, 0, v);
+        }
+        catch (...) {  //空树插入失败，不留下没有值的根
+            delete_node(root);
+            root = 0;
+            throw;
+        }
+    } else if (!position.node->leaf) {
+        --position;
+        ++position.position;
+    }
+    node_ptr x = position.node;
+    int i = position.position;
+    if (x->count < node_values) return insert_in_node(x, i, v);
+    //先复制出v再分裂：在节点末尾分裂时新节点是空的，
+    //分裂以后复制抛出异常就会留下一个空叶子
+    value_type tmp(v);
+    split(x, i);
+    return insert_in_node(x, i, std::move(tmp));
+}
+
+//未满的节点x中在i处插入，构造抛出异常时把挪开的值移回去
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+template <class Arg>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::insert_in_node(node_ptr x, int i, Arg&& v) {
+    for (int j = x->count; j > i; --j) move_value(x, j, x, j - 1);
+    try {
+        construct(x->value(i), std::forward<Arg>(v));
+    }
+    catch (...) {
+        for (int j = i; j < x->count; ++j) move_value(x, j, x, j + 1);
+        throw;
+    }
+    ++x->count;
+    ++node_count;
+    return iterator(x, i);
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+std::pair<typename btree<K, V, KoV, Cmp, Al, S>::iterator, bool>
+btree<K, V, KoV, Cmp, Al, S>::insert_unique(const value_type& v) {
+    if (root == 0) return std::pair<iterator, bool>(insert_at(end(), v), true);
+    const K& k = KoV()(v);
+    node_ptr x = root;
+    for (;;) {
+        int i = lower_in(x, k);
+        if (equal_at(x, i, k))
+            return std::pair<iterator, bool>(iterator(x, i), false);
+        if (x->leaf)
+            return std::pair<iterator, bool>(insert_at(iterator(x, i), v),
+                                             true);
+        x = x->child(i);
+    }
+}
+
+//位置正好在v的前后两个元素之间时直接插入，已排序的输入以end()为提示
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::insert_unique(iterator position,
+                                            const value_type& v) {
+    const K& k = KoV()(v);
+    if (node_count > 0 &&
+        (position == end() || key_compare(k, KoV()(*position)))) {
+        if (position == begin()) return insert_at(position, v);
+        iterator before = position;
+        --before;
+        if (key_compare(KoV()(*before), k)) return insert_at(position, v);
+    }
+    return insert_unique(v).first;
+}
+
+//内部节点的值先和前驱交换，删除总是发生在叶子上
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+void btree<K, V, KoV, Cmp, Al, S>::erase(iterator position) {
+    node_ptr x = position.node;
+    int i = position.position;
+    destroy(x->value(i));
+    if (!x->leaf) {
+        iterator before = position;
+        --before;
+        move_value(x, i, before.node, before.position);
+        x = before.node;
+        i = before.position;
+    } else {
+        for (; i + 1 < x->count; ++i) move_value(x, i, x, i + 1);
+    }
+    --x->count;
+    --node_count;
+    rebalance_after_erase(x);
+}
+
+//叶子x删掉一个值后，不足min_values时向兄弟借一个，兄弟也不够就合并，
+//合并使父节点少一个值，继续往上调整
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+void btree<K, V, KoV, Cmp, Al, S>::rebalance_after_erase(node_ptr x) {
+    while (x != root && x->count < min_values) {
+        node_ptr parent = x->parent;
+        int p = x->position;
+        node_ptr left = p > 0 ? parent->child(p - 1) : 0;
+        node_ptr right = p < parent->count ? parent->child(p + 1) : 0;
+        if (left && left->count > min_values) {  //父节点的值下移，左兄弟的上移
+            for (int j = x->count; j > 0; --j) move_value(x, j, x, j - 1);
+            if (!x->leaf)
+                for (int j = x->count + 1; j > 0; --j)
+                    x->set_child(j, x->child(j - 1));
+            move_value(x, 0, parent, p - 1);
+            move_value(parent, p - 1, left, left->count - 1);
+            if (!x->leaf) x->set_child(0, left->child(left->count));
+            --left->count;
+            ++x->count;
+            return;
+        }
+        if (right && right->count > min_values) {
+            move_value(x, x->count, parent, p);
+            move_value(parent, p, right, 0);
+            if (!x->leaf) x->set_child(x->count + 1, right->child(0));
+            for (int j = 1; j < right->count; ++j)
+                move_value(right, j - 1, right, j);
+            if (!right->leaf)
+                for (int j = 1; j <= right->count; ++j)
+                    right->set_child(j - 1, right->child(j));
+            --right->count;
+            ++x->count;
+            return;
+        }
+        //合并：右边的节点连同父节点中的分隔值并入左边
+        if (left) {
+            right = x;
+            x = left;
+            --p;
+        }
+        int n = x->count;
+        move_value(x, n, parent, p);
+        for (int j = 0; j < right->count; ++j)
+            move_value(x, n + 1 + j, right, j);
+        if (!x->leaf)
+            for (int j = 0; j <= right->count; ++j)
+                x->set_child(n + 1 + j, right->child(j));
+        x->count += 1 + right->count;
+        right->count = 0;
+        delete_node(right);
+        for (int j = p + 1; j < parent->count; ++j) {
+            move_value(parent, j - 1, parent, j);
+            parent->set_child(j, parent->child(j + 1));
+        }
+        --parent->count;
+        x = parent;
+    }
+    if (root->count == 0) {  //根空了：树变矮或者变空
+        node_ptr old = root;
+        if (old->leaf)
+            root = 0;
+        else {
+            root = old->child(0);
+            root->parent = 0;
+            root->position = 0;
+        }
+        delete_node(old);
+    }
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::size_type
+btree<K, V, KoV, Cmp, Al, S>::erase(const K& k) {
+    iterator it = find(k);
+    if (it == end()) return 0;
+    erase(it);
+    return 1;
+}
+
+//删除会搬动元素，每删一个按键重新定位下一个
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+void btree<K, V, KoV, Cmp, Al, S>::erase(iterator first, iterator last) {
+    if (first == begin() && last == end()) {
+        clear();
+        return;
+    }
+    size_type n = TinySTL::distance(first, last);
+    while (n-- > 0) {
+        K k = KoV()(*first);
+        erase(first);
+        first = lower_bound(k);
+    }
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::find(const K& k) {
+    for (node_ptr x = root; x;) {
+        int i = lower_in(x, k);
+        if (equal_at(x, i, k)) return iterator(x, i);
+        if (x->leaf) break;
+        x = x->child(i);
+    }
+    return end();
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::lower_bound(const K& k) {
+    if (root == 0) return end();
+    node_ptr x = root;
+    for (;;) {
+        int i = lower_in(x, k);
+        if (equal_at(x, i, k)) return iterator(x, i);
+        if (x->leaf) return fix_position(x, i);
+        x = x->child(i);
+    }
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+typename btree<K, V, KoV, Cmp, Al, S>::iterator
+btree<K, V, KoV, Cmp, Al, S>::upper_bound(const K& k) {
+    if (root == 0) return end();
+    node_ptr x = root;
+    for (;;) {
+        int i = lower_in(x, k);
+        if (equal_at(x, i, k)) ++i;
+        if (x->leaf) return fix_position(x, i);
+        x = x->child(i);
+    }
+}
+
+//返回子树高度，n累加元素个数，结构不对时返回-1
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+int btree<K, V, KoV, Cmp, Al, S>::__verify_node(node_ptr x,
+                                                size_type& n) const {
+    if (x != root && (x->count == 0 || x->count > node_values)) return -1;
+    for (int i = 1; i < x->count; ++i)
+        if (!key_compare(key(x, i - 1), key(x, i))) return -1;
+    n += x->count;
+    if (x->leaf) return 1;
+    int height = -1;
+    for (int i = 0; i <= x->count; ++i) {
+        node_ptr c = x->child(i);
+        if (c->parent != x || c->position != i) return -1;
+        if (i > 0 && !key_compare(key(x, i - 1), key(c, 0))) return -1;
+        if (i < x->count && !key_compare(key(c, c->count - 1), key(x, i)))
+            return -1;
+        int h = __verify_node(c, n);
+        if (h < 0 || (height != -1 && h != height)) return -1;
+        height = h;
+    }
+    return height + 1;
+}
+
+template <class K, class V, class KoV, class Cmp, class Al, int S>
+bool btree<K, V, KoV, Cmp, Al, S>::__btree_verify() const {
+    if (root == 0) return node_count == 0;
+    if (root->parent != 0 || root->count == 0) return false;
+    size_type n = 0;
+    return __verify_node(root, n) > 0 && n == node_count &&
+           size_type(TinySTL::distance(begin(), end())) == node_count;
+}
+
+}  // namespace TinySTL
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef BTREEMAP_H__
+#define BTREEMAP_H__
+
+#include <functional>
+#include <utility>
+#include "Alloc.h"
+#include "BTree.h"
+#include "Function.h"
+
+namespace TinySTL {
+
+//接口同map，底层是B树：节点大、层数少，查找和遍历的缓存未命中少得多
+//插入删除会在节点间搬动元素，所有迭代器都会失效，这一点和map不同
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = alloc>
+class btree_map;
+
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const btree_map<Key, T, Compare, Alloc>& x,
+                const btree_map<Key, T, Compare, Alloc>& y);
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const btree_map<Key, T, Compare, Alloc>& x,
+               const btree_map<Key, T, Compare, Alloc>& y);
+
+template <class Key, class T, class Compare, class Alloc>
+class btree_map {
+   public:
+    // typedefs:
+
+    typedef Key key_type;
+    typedef T data_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+
+    class value_compare : public binary_function<value_type, value_type, bool> {
+        friend class btree_map<Key, T, Compare, Alloc>;
+
+       protected:
+        Compare comp;
+        value_compare(Compare c) : comp(c) {}
+
+       public:
+        bool operator()(const value_type& x, const value_type& y) const {
+            return comp(x.first, y.first);
+        }
+    };
+
+   private:
+    typedef btree<key_type, value_type, select1st<value_type>, key_compare,
+                  Alloc>
+        rep_type;
+    rep_type t;  // B-tree representing map
+   public:
+    typedef typename rep_type::pointer pointer;
+    typedef typename rep_type::const_pointer const_pointer;
+    typedef typename rep_type::reference reference;
+    typedef typename rep_type::const_reference const_reference;
+    typedef typename rep_type::iterator iterator;
+    typedef typename rep_type::const_iterator const_iterator;
+    typedef typename rep_type::reverse_iterator reverse_iterator;
+    typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename rep_type::size_type size_type;
+    typedef typename rep_type::difference_type difference_type;
+
+    // allocation/deallocation
+
+    btree_map() : t(Compare()) {}
+    explicit btree_map(const Compare& comp) : t(comp) {}
+
+    //区间已排序时每次都插在最右的叶子上，不用从根查找
+    template <class InputIterator>
+    btree_map(InputIterator first, InputIterator last) : t(Compare()) {
+        t.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    btree_map(InputIterator first, InputIterator last, const Compare& comp)
+        : t(comp) {
+        t.insert_unique(first, last);
+    }
+
+    btree_map(const btree_map<Key, T, Compare, Alloc>& x) : t(x.t) {}
+    btree_map<Key, T, Compare, Alloc>& operator=(
+        const btree_map<Key, T, Compare, Alloc>& x) {
+        t = x.t;
+        return *this;
+    }
+
+    // accessors:
+
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return value_compare(t.key_comp()); }
+    iterator begin() { return t.begin(); }
+    const_iterator begin() const { return t.begin(); }
+    iterator end() { return t.end(); }
+    const_iterator end() const { return t.end(); }
+    reverse_iterator rbegin() { return t.rbegin(); }
+    const_reverse_iterator rbegin() const { return t.rbegin(); }
+    reverse_iterator rend() { return t.rend(); }
+    const_reverse_iterator rend() const { return t.rend(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    T& operator[](const key_type& k) {
+        return (*((insert(value_type(k, T()))).first)).second;
+    }
+    void swap(btree_map<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+
+    // insert/erase
+
+    std::pair<iterator, bool> insert(const value_type& x) {
+        return t.insert_unique(x);
+    }
+    iterator insert(iterator position, const value_type& x) {
+        return t.insert_unique(position, x);
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        t.insert_unique(first, last);
+    }
+
+    void erase(iterator position) { t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(iterator first, iterator last) { t.erase(first, last); }
+    void clear() { t.clear(); }
+
+    // map operations:
+
+    iterator find(const key_type& x) { return t.find(x); }
+    const_iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+    const_iterator lower_bound(const key_type& x) const {
+        return t.lower_bound(x);
+    }
+    iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+    const_iterator upper_bound(const key_type& x) const {
+        return t.upper_bound(x);
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type& x) {
+        return t.equal_range(x);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& x) const {
+        return t.equal_range(x);
+    }
+    friend bool operator== <>(const btree_map&, const btree_map&);
+    friend bool operator< <>(const btree_map&, const btree_map&);
+};
+
+template <class Key, class T, class Compare, class Alloc>
+inline bool operator==(const btree_map<Key, T, Compare, Alloc>& x,
+                       const btree_map<Key, T, Compare, Alloc>& y) {
+    return x.t == y.t;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+inline bool operator<(const btree_map<Key, T, Compare, Alloc>& x,
+                      const btree_map<Key, T, Compare, Alloc>& y) {
+    return x.t < y.t;
+}
+
+template <class Key, class T, class Compare, class Alloc>
+inline void swap(btree_map<Key, T, Compare, Alloc>& x,
+                 btree_map<Key, T, Compare, Alloc>& y) {
+    x.swap(y);
+}
+
+}  // namespace TinySTL
+
+#endif
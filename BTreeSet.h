@@ -0,0 +1,139 @@
+#ifndef BTREESET_H__
+#define BTREESET_H__
+
+#include <functional>
+#include <utility>
+#include "Alloc.h"
+#include "BTree.h"
+#include "Function.h"
+
+namespace TinySTL {
+
+//接口同set，底层是B树，插入删除使所有迭代器失效，见btree_map
+template <class Key, class Compare = std::less<Key>, class Alloc = alloc>
+class btree_set;
+
+template <class Key, class Compare, class Alloc>
+bool operator==(const btree_set<Key, Compare, Alloc>& x,
+                const btree_set<Key, Compare, Alloc>& y);
+template <class Key, class Compare, class Alloc>
+bool operator<(const btree_set<Key, Compare, Alloc>& x,
+               const btree_set<Key, Compare, Alloc>& y);
+
+template <class Key, class Compare, class Alloc>
+class btree_set {
+   public:
+
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+
+   private:
+    typedef btree<key_type, value_type, identity<value_type>, key_compare,
+                  Alloc>
+        rep_type;
+    rep_type t;  // B-tree representing set
+   public:
+    typedef typename rep_type::const_pointer pointer;
+    typedef typename rep_type::const_pointer const_pointer;
+    typedef typename rep_type::const_reference reference;
+    typedef typename rep_type::const_reference const_reference;
+    typedef typename rep_type::const_iterator iterator;
+    typedef typename rep_type::const_iterator const_iterator;
+    typedef typename rep_type::const_reverse_iterator reverse_iterator;
+    typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename rep_type::size_type size_type;
+    typedef typename rep_type::difference_type difference_type;
+
+    // allocation/deallocation
+
+    btree_set() : t(Compare()) {}
+    explicit btree_set(const Compare& comp) : t(comp) {}
+
+    //区间已排序时每次都插在最右的叶子上，不用从根查找
+    template <class InputIterator>
+    btree_set(InputIterator first, InputIterator last) : t(Compare()) {
+        t.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    btree_set(InputIterator first, InputIterator last, const Compare& comp)
+        : t(comp) {
+        t.insert_unique(first, last);
+    }
+
+    btree_set(const btree_set<Key, Compare, Alloc>& x) : t(x.t) {}
+    btree_set<Key, Compare, Alloc>& operator=(
+        const btree_set<Key, Compare, Alloc>& x) {
+        t = x.t;
+        return *this;
+    }
+
+    // accessors:
+
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return t.key_comp(); }
+    iterator begin() const { return t.begin(); }
+    iterator end() const { return t.end(); }
+    reverse_iterator rbegin() const { return t.rbegin(); }
+    reverse_iterator rend() const { return t.rend(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    void swap(btree_set<Key, Compare, Alloc>& x) { t.swap(x.t); }
+
+    // insert/erase
+    typedef std::pair<iterator, bool> pair_iterator_bool;
+    std::pair<iterator, bool> insert(const value_type& x) {
+        std::pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
+        return std::pair<iterator, bool>(p.first, p.second);
+    }
+    iterator insert(iterator position, const value_type& x) {
+        typedef typename rep_type::iterator rep_iterator;
+        return t.insert_unique((rep_iterator&)position, x);
+    }
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        t.insert_unique(first, last);
+    }
+
+    void erase(iterator position) {
+        typedef typename rep_type::iterator rep_iterator;
+        t.erase((rep_iterator&)position);
+    }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(iterator first, iterator last) {
+        typedef typename rep_type::iterator rep_iterator;
+        t.erase((rep_iterator&)first, (rep_iterator&)last);
+    }
+    void clear() { t.clear(); }
+
+    // set operations:
+
+    iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    std::pair<iterator, iterator> equal_range(const key_type& x) const {
+        return t.equal_range(x);
+    }
+    friend bool operator== <>(const btree_set&, const btree_set&);
+    friend bool operator< <>(const btree_set&, const btree_set&);
+};
+
+template <class Key, class Compare, class Alloc>
+inline bool operator==(const btree_set<Key, Compare, Alloc>& x,
+                       const btree_set<Key, Compare, Alloc>& y) {
+    return x.t == y.t;
+}
+
+template <class Key, class Compare, class Alloc>
+inline bool operator<(const btree_set<Key, Compare, Alloc>& x,
+                      const btree_set<Key, Compare, Alloc>& y) {
+    return x.t < y.t;
+}
+
+}  // namespace TinySTL
+
+#endif
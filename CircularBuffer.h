@@ -0,0 +1,250 @@
+#ifndef CIRCULARBUFFER_H__
+#define CIRCULARBUFFER_H__
+
+#include <cstddef>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Iterator.h"
+#include "Uninitialized.h"
+
+namespace TinySTL {
+
+template <class T, class Ref, class Ptr>
+struct __circular_buffer_iterator {
+    typedef __circular_buffer_iterator<T, T&, T*> iterator;
+    typedef __circular_buffer_iterator<T, const T&, const T*> const_iterator;
+    typedef __circular_buffer_iterator self;
+
+    typedef random_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    T* first;          //存储区起点
+    size_type cap;     //存储区容量
+    size_type head;    //首元素在存储区中的下标
+    size_type index;   //相对首元素的逻辑下标，end()时等于size()
+
+    __circular_buffer_iterator(T* f, size_type c, size_type h, size_type i)
+        : first(f), cap(c), head(h), index(i) {}
+    __circular_buffer_iterator() : first(0), cap(0), head(0), index(0) {}
+    __circular_buffer_iterator(const iterator& x)
+        : first(x.first), cap(x.cap), head(x.head), index(x.index) {}
+
+    //逻辑下标换算成存储区中的位置，head和index都不超过cap，只需回绕一次
+    T* ptr() const {
+        size_type i = head + index;
+        return first + (i >= cap ? i - cap : i);
+    }
+    reference operator*() const { return *ptr(); }
+    pointer operator->() const { return ptr(); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    difference_type operator-(const self& x) const {
+        return difference_type(index) - difference_type(x.index);
+    }
+
+    self& operator++() {
+        ++index;
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++index;
+        return tmp;
+    }
+    self& operator--() {
+        --index;
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --index;
+        return tmp;
+    }
+    self& operator+=(difference_type n) {
+        index += n;
+        return *this;
+    }
+    self& operator-=(difference_type n) { return *this += -n; }
+    self operator+(difference_type n) const {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(difference_type n) const {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return index < x.index; }
+    bool operator>(const self& x) const { return index > x.index; }
+    bool operator<=(const self& x) const { return index <= x.index; }
+    bool operator>=(const self& x) const { return index >= x.index; }
+};
+
+//固定容量的环形缓冲区，元素放在一块连续存储区里，首尾相接
+//两端push/pop都是O(1)，不会像deque那样配置新缓冲区或重整map
+//满时默认拒绝push（返回false）；打开覆盖模式后push_back挤掉最早的元素，
+//push_front挤掉最晚的元素，适合当滑动窗口用
+//内容最多分成两段连续区间，array_one()是从首元素到存储区尾的一段，
+//array_two()是回绕到存储区头的一段，可以直接交给批处理代码
+template <class T, class Alloc = alloc>
+class circular_buffer {
+   public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef __circular_buffer_iterator<T, T&, T*> iterator;
+    typedef __circular_buffer_iterator<T, const T&, const T*> const_iterator;
+
+    typedef std::pair<pointer, size_type> array_range;
+    typedef std::pair<const_pointer, size_type> const_array_range;
+
+   protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+
+    pointer first;     //存储区
+    size_type cap;
+    size_type head;    //首元素下标
+    size_type count;   //元素个数
+    bool overwrite;
+
+    //逻辑下标换算成存储区下标，i不超过cap
+    size_type physical(size_type i) const {
+        i += head;
+        return i >= cap ? i - cap : i;
+    }
+    size_type first_span() const {
+        return count < cap - head ? count : cap - head;
+    }
+
+   public:
+    explicit circular_buffer(size_type capacity, bool overwrite_when_full = false)
+        : first(capacity ? data_allocator::allocate(capacity) : 0),
+          cap(capacity),
+          head(0),
+          count(0),
+          overwrite(overwrite_when_full) {}
+    circular_buffer(const circular_buffer& x)
+        : first(x.cap ? data_allocator::allocate(x.cap) : 0),
+          cap(x.cap),
+          head(0),
+          count(x.count),
+          overwrite(x.overwrite) {
+        const_array_range one = x.array_one(), two = x.array_two();
+        TinySTL::uninitialized_copy(two.first, two.first + two.second,
+                                    TinySTL::uninitialized_copy(
+                                        one.first, one.first + one.second,
+                                        first));
+    }
+    ~circular_buffer() {
+        clear();
+        if (first) data_allocator::deallocate(first, cap);
+    }
+    circular_buffer& operator=(const circular_buffer& x) {
+        if (this != &x) {
+            circular_buffer tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    void swap(circular_buffer& x) {
+        std::swap(first, x.first);
+        std::swap(cap, x.cap);
+        std::swap(head, x.head);
+        std::swap(count, x.count);
+        std::swap(overwrite, x.overwrite);
+    }
+
+   public:
+    iterator begin() { return iterator(first, cap, head, 0); }
+    iterator end() { return iterator(first, cap, head, count); }
+    const_iterator begin() const { return const_iterator(first, cap, head, 0); }
+    const_iterator end() const {
+        return const_iterator(first, cap, head, count);
+    }
+
+    size_type size() const { return count; }
+    size_type capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == cap; }
+    bool overwrite_mode() const { return overwrite; }
+    void set_overwrite_mode(bool on) { overwrite = on; }
+
+    reference operator[](size_type n) { return first[physical(n)]; }
+    const_reference operator[](size_type n) const { return first[physical(n)]; }
+    reference front() { return first[head]; }
+    const_reference front() const { return first[head]; }
+    reference back() { return first[physical(count - 1)]; }
+    const_reference back() const { return first[physical(count - 1)]; }
+
+    array_range array_one() { return array_range(first + head, first_span()); }
+    array_range array_two() { return array_range(first, count - first_span()); }
+    const_array_range array_one() const {
+        return const_array_range(first + head, first_span());
+    }
+    const_array_range array_two() const {
+        return const_array_range(first, count - first_span());
+    }
+
+   public:
+    //满了且不在覆盖模式时返回false
+    bool push_back(const value_type& x) {
+        if (count == cap) {
+            if (!overwrite || cap == 0) return false;
+            first[head] = x;  //最早的元素所在的槽位就是新的尾
+            if (++head == cap) head = 0;
+            return true;
+        }
+        construct(first + physical(count), x);
+        ++count;
+        return true;
+    }
+    bool push_front(const value_type& x) {
+        if (count == cap && (!overwrite || cap == 0)) return false;
+        size_type h = (head == 0 ? cap : head) - 1;
+        if (count == cap)
+            first[h] = x;  //最晚的元素所在的槽位就是新的首
+        else {
+            construct(first + h, x);
+            ++count;
+        }
+        head = h;
+        return true;
+    }
+    void pop_front() {
+        destroy(first + head);
+        if (++head == cap) head = 0;
+        --count;
+    }
+    void pop_back() {
+        destroy(first + physical(count - 1));
+        --count;
+    }
+    //从前端丢掉n个元素，通常在处理完array_one()/array_two()之后调用
+    void pop_front(size_type n) {
+        size_type k = n < cap - head ? n : cap - head;
+        destroy(first + head, first + head + k);
+        destroy(first, first + (n - k));
+        head = physical(n);
+        count -= n;
+    }
+    void clear() {
+        pop_front(count);
+        head = 0;
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
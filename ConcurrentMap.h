@@ -0,0 +1,347 @@
+#ifndef CONCURRENTMAP_H__
+#define CONCURRENTMAP_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Iterator.h"
+#include "Queue.h"  // __backoff
+
+namespace TinySTL {
+
+template <class Value>
+struct __cmap_node {
+    Value value;                      //头节点不构造
+    int height;                       //占用next[0, height)
+    std::atomic<bool> lock;           //修改后继指针时持有
+    std::atomic<bool> marked;         //已被逻辑删除
+    std::atomic<bool> fully_linked;   //各层都已链好
+    __cmap_node* retired;             //删除后挂到退休链表，析构时释放
+    std::atomic<__cmap_node*> next[1];  //实际有height个
+
+    void acquire() {
+        __backoff b;
+        while (lock.exchange(true, std::memory_order_acquire)) b.pause();
+    }
+    void release() { lock.store(false, std::memory_order_release); }
+    bool valid() const {
+        return fully_linked.load(std::memory_order_acquire) &&
+               !marked.load(std::memory_order_acquire);
+    }
+};
+
+//只读迭代器，沿第0层前进，跳过已删除和尚未链好的节点
+//弱一致：遍历期间的插入删除可能看得到也可能看不到，但不会失效
+template <class Value>
+struct __cmap_iterator {
+    typedef __cmap_node<Value>* link_type;
+    typedef __cmap_iterator self;
+
+    typedef forward_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef const Value* pointer;
+    typedef const Value& reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    link_type node;
+
+    __cmap_iterator() : node(0) {}
+    explicit __cmap_iterator(link_type x) : node(x) {}
+
+    //前进到第一个有效节点
+    self& skip() {
+        while (node && !node->valid())
+            node = node->next[0].load(std::memory_order_acquire);
+        return *this;
+    }
+    reference operator*() const { return node->value; }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++() {
+        node = node->next[0].load(std::memory_order_acquire);
+        skip();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+};
+
+//并发有序map，用懒惰跳表实现（Herlihy等人的lazy skip list）
+//读（find、lower_bound、遍历）不加锁也不重试，只沿next指针走并检查标记
+//写只锁住各层的前驱节点，验证前驱未被删除且仍指向原后继后再改指针，
+//不同位置的插入删除互不阻塞
+//值在插入后不可修改；删除的节点只从链表摘下，读者可能还在用，
+//挂到退休链表上到析构时才释放，删除频繁的场景内存会一直增长
+//节点在多个线程中配置，默认用线程安全的malloc_alloc
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = malloc_alloc>
+class concurrent_map {
+   public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    typedef size_t size_type;
+    typedef __cmap_iterator<value_type> const_iterator;
+    typedef const_iterator iterator;
+
+   protected:
+    typedef __cmap_node<value_type> node;
+    typedef node* link_type;
+    enum { max_height = 16 };  //每层以1/4的概率晋升，足够容纳4^16个元素
+
+    link_type head;
+    std::atomic<link_type> retired;
+    std::atomic<size_type> node_count;
+    Compare comp;
+
+    static link_type allocate_node(int height) {
+        link_type p = (link_type)Alloc::allocate(
+            sizeof(node) + (height - 1) * sizeof(std::atomic<link_type>));
+        p->height = height;
+        construct(&p->lock, false);
+        construct(&p->marked, false);
+        construct(&p->fully_linked, false);
+        p->retired = 0;
+        for (int i = 0; i < height; ++i) construct(&p->next[i], link_type(0));
+        return p;
+    }
+    static void deallocate_node(link_type p) {
+        Alloc::deallocate(p, sizeof(node) + (p->height - 1) *
+                                                sizeof(std::atomic<link_type>));
+    }
+    static void destroy_node(link_type p) {
+        destroy(&p->value);
+        deallocate_node(p);
+    }
+
+    static int random_height() {
+        static thread_local uint32_t seed = 0;
+        if (seed == 0) seed = uint32_t(uintptr_t(&seed) >> 4) | 1;
+        seed ^= seed << 13;  // xorshift32
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int h = 1;
+        for (uint32_t r = seed; h < max_height && (r & 3) == 0; r >>= 2) ++h;
+        return h;
+    }
+
+    static const Key& key(link_type p) { return p->value.first; }
+
+    //找出每层最后一个小于k的节点及其后继，返回k所在的最高层，不存在时返回-1
+    int find_node(const Key& k, link_type* preds, link_type* succs) const {
+        int found = -1;
+        link_type pred = head;
+        for (int l = max_height - 1; l >= 0; --l) {
+            link_type cur = pred->next[l].load(std::memory_order_acquire);
+            while (cur && comp(key(cur), k)) {
+                pred = cur;
+                cur = pred->next[l].load(std::memory_order_acquire);
+            }
+            if (found == -1 && cur && !comp(k, key(cur))) found = l;
+            preds[l] = pred;
+            succs[l] = cur;
+        }
+        return found;
+    }
+
+    //第一个不小于k的节点，可能已被删除
+    link_type lower_bound_node(const Key& k) const {
+        link_type pred = head, cur = 0;
+        for (int l = max_height - 1; l >= 0; --l) {
+            cur = pred->next[l].load(std::memory_order_acquire);
+            while (cur && comp(key(cur), k)) {
+                pred = cur;
+                cur = pred->next[l].load(std::memory_order_acquire);
+            }
+        }
+        return cur;
+    }
+
+    //依次锁住preds[0, height)中不重复的节点并验证前驱未被删除且仍指向succs，
+    //插入时还要验证后继未被删除，验证失败返回false
+    //第0层的前驱键最大，从下往上加锁保证所有线程按键的降序加锁，不会死锁
+    static bool lock_preds(link_type* preds, link_type* succs, int height,
+                           bool check_succ, int& locked) {
+        link_type prev = 0;
+        locked = 0;
+        for (int l = 0; l < height; ++l) {
+            link_type pred = preds[l], succ = succs[l];
+            if (pred != prev) {
+                pred->acquire();
+                prev = pred;
+            }
+            locked = l + 1;
+            if (pred->marked.load(std::memory_order_acquire) ||
+                (check_succ && succ &&
+                 succ->marked.load(std::memory_order_acquire)) ||
+                pred->next[l].load(std::memory_order_acquire) != succ)
+                return false;
+        }
+        return true;
+    }
+    static void unlock_preds(link_type* preds, int locked) {
+        link_type prev = 0;
+        for (int l = 0; l < locked; ++l)
+            if (preds[l] != prev) {
+                prev = preds[l];
+                prev->release();
+            }
+    }
+
+    void retire(link_type p) {
+        link_type old = retired.load(std::memory_order_relaxed);
+        do
+            p->retired = old;
+        while (!retired.compare_exchange_weak(old, p,
+                                              std::memory_order_relaxed));
+    }
+
+   public:
+    explicit concurrent_map(const Compare& c = Compare())
+        : head(allocate_node(max_height)),
+          retired(0),
+          node_count(0),
+          comp(c) {}
+    //析构时不能有其他线程在使用
+    ~concurrent_map() {
+        for (link_type p = head->next[0].load(std::memory_order_relaxed); p;) {
+            link_type next = p->next[0].load(std::memory_order_relaxed);
+            destroy_node(p);
+            p = next;
+        }
+        for (link_type p = retired.load(std::memory_order_relaxed); p;) {
+            link_type next = p->retired;
+            destroy_node(p);
+            p = next;
+        }
+        deallocate_node(head);
+    }
+
+   private:
+    concurrent_map(const concurrent_map&);
+    concurrent_map& operator=(const concurrent_map&);
+
+   public:
+    const_iterator begin() const {
+        return const_iterator(head->next[0].load(std::memory_order_acquire))
+            .skip();
+    }
+    const_iterator end() const { return const_iterator(); }
+    //其他线程可能同时在修改，结果只是近似值
+    size_type size() const {
+        return node_count.load(std::memory_order_relaxed);
+    }
+    bool empty() const { return size() == 0; }
+    key_compare key_comp() const { return comp; }
+
+    //不能从p再跳到后面的节点，那样会返回别的键
+    const_iterator find(const Key& k) const {
+        link_type p = lower_bound_node(k);
+        if (p && !comp(k, key(p)) && p->valid()) return const_iterator(p);
+        return end();
+    }
+    //找到时把值复制到x
+    bool find(const Key& k, T& x) const {
+        const_iterator i = find(k);
+        if (i == end()) return false;
+        x = i->second;
+        return true;
+    }
+    size_type count(const Key& k) const { return find(k) != end(); }
+    const_iterator lower_bound(const Key& k) const {
+        return const_iterator(lower_bound_node(k)).skip();
+    }
+    const_iterator upper_bound(const Key& k) const {
+        const_iterator i = lower_bound(k);
+        if (i != end() && !comp(k, i->first)) ++i;
+        return i;
+    }
+
+    //键已存在时不修改，返回已有的元素和false
+    std::pair<const_iterator, bool> insert(const value_type& v) {
+        link_type preds[max_height], succs[max_height];
+        int height = random_height();
+        for (;;) {
+            int found = find_node(v.first, preds, succs);
+            if (found != -1) {
+                link_type p = succs[found];
+                if (!p->marked.load(std::memory_order_acquire)) {
+                    __backoff b;  //等插入它的线程链好
+                    while (!p->fully_linked.load(std::memory_order_acquire))
+                        b.pause();
+                    return std::pair<const_iterator, bool>(const_iterator(p),
+                                                           false);
+                }
+                continue;  //正在被删除，等它摘下后重来
+            }
+            int locked;
+            if (!lock_preds(preds, succs, height, true, locked)) {
+                unlock_preds(preds, locked);
+                continue;
+            }
+            link_type p = allocate_node(height);
+            construct(&p->value, v);
+            for (int l = 0; l < height; ++l)
+                p->next[l].store(succs[l], std::memory_order_relaxed);
+            for (int l = 0; l < height; ++l)
+                preds[l]->next[l].store(p, std::memory_order_release);
+            p->fully_linked.store(true, std::memory_order_release);
+            unlock_preds(preds, locked);
+            node_count.fetch_add(1, std::memory_order_relaxed);
+            return std::pair<const_iterator, bool>(const_iterator(p), true);
+        }
+    }
+
+    //返回删除的元素个数
+    size_type erase(const Key& k) {
+        link_type preds[max_height], succs[max_height];
+        link_type victim = 0;
+        for (;;) {
+            int found = find_node(k, preds, succs);
+            if (!victim) {  //还没有标记，先确认节点可删并标记
+                if (found == -1) return 0;
+                link_type p = succs[found];
+                if (!p->fully_linked.load(std::memory_order_acquire) ||
+                    p->height - 1 != found ||
+                    p->marked.load(std::memory_order_acquire))
+                    return 0;
+                p->acquire();
+                if (p->marked.load(std::memory_order_relaxed)) {
+                    p->release();  //别的线程抢先删除了
+                    return 0;
+                }
+                p->marked.store(true, std::memory_order_release);
+                victim = p;
+            }
+            for (int l = 0; l < victim->height; ++l) succs[l] = victim;
+            int locked;
+            if (!lock_preds(preds, succs, victim->height, false, locked)) {
+                unlock_preds(preds, locked);
+                continue;
+            }
+            for (int l = victim->height - 1; l >= 0; --l)
+                preds[l]->next[l].store(
+                    victim->next[l].load(std::memory_order_relaxed),
+                    std::memory_order_release);
+            victim->release();
+            unlock_preds(preds, locked);
+            retire(victim);
+            node_count.fetch_sub(1, std::memory_order_relaxed);
+            return 1;
+        }
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
@@ -2,6 +2,7 @@
 #define CONSTRUCT_H__
 
 #include <new>
+#include <utility>
 
 #include "Iterator.h"
 #include "TypeTraits.h"
@@ -14,6 +15,12 @@ inline void construct(T1* p, const T2& value) {
     new (p) T1(value);
 }
 
+//用任意参数原地构造，emplace系列用
+template <class T1, class... Args>
+inline void construct(T1* p, Args&&... args) {
+    new (p) T1(std::forward<Args>(args)...);
+}
+
 //接受一个指针调用其析构函数
 template <class T>
 inline void destroy(T* pointer) {
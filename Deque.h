@@ -1,18 +1,42 @@
 #ifndef DEQUE_H__
 #define DEQUE_H__
 
+#include <algorithm>
+#include <cstring>
 #include "Alloc.h"
 #include "Construct.h"
+#include "Uninitialized.h"
 
 namespace TinySTL {
 
+//不超过n的最大的2的幂
+inline constexpr size_t __deque_floor_pow2(size_t n) {
+    return n < 2 ? 1 : 2 * __deque_floor_pow2(n / 2);
+}
+inline constexpr size_t __deque_log2(size_t n) {
+    return n < 2 ? 0 : 1 + __deque_log2(n / 2);
+}
+
+//编译期决定缓冲区大小：BufSiz为0时取不超过512字节的最大的2的幂个元素
+//大小是2的幂时，下标和迭代器运算用移位和掩码代替除法和取模
+template <class T, size_t BufSiz>
+struct __deque_buf_traits {
+    static constexpr size_t value =
+        BufSiz != 0 ? BufSiz
+                    : __deque_floor_pow2(sizeof(T) < 512 ? 512 / sizeof(T) : 1);
+    static constexpr bool pow2 = (value & (value - 1)) == 0;
+    static constexpr size_t shift = __deque_log2(value);
+    static constexpr size_t mask = value - 1;
+};
+
 template <class T, class Ref, class Ptr, size_t BufSiz>
 struct __deque_iterator {
     typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
     typedef __deque_iterator<T, const T&, const T*, BufSiz> const_iterator;
-    static size_t buffer_size() { return __deque_buf_size(BufSiz, sizeof(T)); }
+    typedef __deque_buf_traits<T, BufSiz> buf_traits;
+    static size_t buffer_size() { return buf_traits::value; }
 
-    typedef random_access_iterator_tag iterator_category;
+    typedef random_iterator_tag iterator_category;
     typedef T value_type;
     typedef Ptr pointer;
     typedef Ref reference;
@@ -37,8 +61,9 @@ struct __deque_iterator {
     pointer operator->() const { return &(operator*()); }
 
     difference_type operator-(const self& x) const {
-        return difference_type(buffer_size()) * (node - x.node - 1) +
-               (cur - first) + (x.last - x.cur);
+        //写成这种形式，两个都是默认构造的空迭代器时结果为0
+        return difference_type(buffer_size()) * (node - x.node) +
+               (cur - first) - (x.cur - x.first);
     }
 
     self& operator++() {  //++i
@@ -73,7 +98,11 @@ struct __deque_iterator {
         difference_type offset = n + (cur - first);
         if (offset >= 0 && offset < difference_type(buffer_size()))
             cur += n;
-        else {
+        else if (buf_traits::pow2) {
+            //算术右移即向下取整，offset为负时同样适用
+            set_node(node + (offset >> buf_traits::shift));
+            cur = first + (offset & difference_type(buf_traits::mask));
+        } else {
             difference_type node_offset =
                 offset > 0
                     ? offset / difference_type(buffer_size())
@@ -112,9 +141,166 @@ struct __deque_iterator {
     }
 };
 
-//决定缓冲区大小
-inline size_t __deque_buf_size(size_t n, size_t sz) {
-    return n != 0 ? n : (sz < 512 ? size_t(512 / sz) : size_t(1));
+//针对deque迭代器的算法：按缓冲区分段，每段在原始指针上循环，
+//避免每次++都检查缓冲区边界；POD类型的拷贝直接memmove
+
+template <class T>
+inline T* __deque_copy_seg(const T* first, const T* last, T* result,
+                           _true_type) {
+    memmove(result, first, sizeof(T) * (last - first));
+    return result + (last - first);
+}
+
+template <class T>
+inline T* __deque_copy_seg(const T* first, const T* last, T* result,
+                           _false_type) {
+    for (; first != last; ++first, ++result) *result = *first;
+    return result;
+}
+
+template <class T>
+inline T* __deque_copy_backward_seg(const T* first, const T* last, T* result,
+                                    _true_type) {
+    result -= last - first;
+    memmove(result, first, sizeof(T) * (last - first));
+    return result;
+}
+
+template <class T>
+inline T* __deque_copy_backward_seg(const T* first, const T* last, T* result,
+                                    _false_type) {
+    while (first != last) *--result = *--last;
+    return result;
+}
+
+template <class T, class Ref, class Ptr, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz> copy(
+    __deque_iterator<T, Ref, Ptr, BufSiz> first,
+    __deque_iterator<T, Ref, Ptr, BufSiz> last,
+    __deque_iterator<T, T&, T*, BufSiz> result) {
+    typedef typename _type_traits<T>::is_POD_type is_POD;
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        ptrdiff_t len = std::min(n, std::min(first.last - first.cur,
+                                             result.last - result.cur));
+        __deque_copy_seg((const T*)first.cur, (const T*)first.cur + len,
+                         result.cur, is_POD());
+        first += len;
+        result += len;
+        n -= len;
+    }
+    return result;
+}
+
+template <class T, class Ref, class Ptr, size_t BufSiz>
+__deque_iterator<T, T&, T*, BufSiz> copy_backward(
+    __deque_iterator<T, Ref, Ptr, BufSiz> first,
+    __deque_iterator<T, Ref, Ptr, BufSiz> last,
+    __deque_iterator<T, T&, T*, BufSiz> result) {
+    typedef typename _type_traits<T>::is_POD_type is_POD;
+    const ptrdiff_t buf = __deque_buf_traits<T, BufSiz>::value;
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        //last或result在缓冲区开头时，这一段在前一个缓冲区的尾部
+        ptrdiff_t llen = last.cur - last.first;
+        const T* lend = last.cur;
+        if (llen == 0) {
+            llen = buf;
+            lend = *(last.node - 1) + buf;
+        }
+        ptrdiff_t rlen = result.cur - result.first;
+        T* rend = result.cur;
+        if (rlen == 0) {
+            rlen = buf;
+            rend = *(result.node - 1) + buf;
+        }
+        ptrdiff_t len = std::min(n, std::min(llen, rlen));
+        __deque_copy_backward_seg(lend - len, lend, rend, is_POD());
+        last -= len;
+        result -= len;
+        n -= len;
+    }
+    return result;
+}
+
+template <class T, size_t BufSiz, class U>
+void fill(__deque_iterator<T, T&, T*, BufSiz> first,
+          __deque_iterator<T, T&, T*, BufSiz> last, const U& value) {
+    if (first.node == last.node) {
+        std::fill(first.cur, last.cur, value);
+        return;
+    }
+    std::fill(first.cur, first.last, value);
+    for (T** node = first.node + 1; node < last.node; ++node)
+        std::fill(*node, *node + __deque_buf_traits<T, BufSiz>::value, value);
+    std::fill(last.first, last.cur, value);
+}
+
+template <class T, class Ref, class Ptr, size_t BufSiz, class U>
+__deque_iterator<T, Ref, Ptr, BufSiz> find(
+    __deque_iterator<T, Ref, Ptr, BufSiz> first,
+    __deque_iterator<T, Ref, Ptr, BufSiz> last, const U& value) {
+    while (first.node != last.node) {
+        for (T* cur = first.cur; cur != first.last; ++cur)
+            if (*cur == value) {
+                first.cur = cur;
+                return first;
+            }
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    for (T* cur = first.cur; cur != last.cur; ++cur)
+        if (*cur == value) {
+            first.cur = cur;
+            return first;
+        }
+    return last;
+}
+
+template <class T, class Ref, class Ptr, size_t BufSiz, class Function>
+Function for_each(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                  __deque_iterator<T, Ref, Ptr, BufSiz> last, Function f) {
+    while (first.node != last.node) {
+        for (T* cur = first.cur; cur != first.last; ++cur) f(*(Ptr)cur);
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    for (T* cur = first.cur; cur != last.cur; ++cur) f(*(Ptr)cur);
+    return f;
+}
+
+template <class T, class Ref1, class Ptr1, class Ref2, class Ptr2,
+          size_t BufSiz>
+bool equal(__deque_iterator<T, Ref1, Ptr1, BufSiz> first1,
+           __deque_iterator<T, Ref1, Ptr1, BufSiz> last1,
+           __deque_iterator<T, Ref2, Ptr2, BufSiz> first2) {
+    ptrdiff_t n = last1 - first1;
+    while (n > 0) {
+        ptrdiff_t len = std::min(n, std::min(first1.last - first1.cur,
+                                             first2.last - first2.cur));
+        const T* p = first1.cur;
+        const T* q = first2.cur;
+        for (const T* end = p + len; p != end; ++p, ++q)
+            if (!(*p == *q)) return false;
+        first1 += len;
+        first2 += len;
+        n -= len;
+    }
+    return true;
+}
+
+//逐段析构，平凡析构的类型什么也不做
+template <class T, class Ref, class Ptr, size_t BufSiz>
+void destroy(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+             __deque_iterator<T, Ref, Ptr, BufSiz> last) {
+    if (first.node == last.node) {
+        destroy(first.cur, last.cur);
+        return;
+    }
+    destroy(first.cur, first.last);
+    for (T** node = first.node + 1; node < last.node; ++node)
+        destroy(*node, *node + __deque_buf_traits<T, BufSiz>::value);
+    destroy(last.first, last.cur);
 }
 
 template <class T, class Alloc = alloc, size_t BufSiz = 0>
@@ -123,21 +309,23 @@ class deque {
     typedef T value_type;
     typedef value_type* pointer;
     typedef value_type& reference;
+    typedef const value_type& const_reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
 
    public:  // Iterators
     typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
+    typedef __deque_iterator<T, const T&, const T*, BufSiz> const_iterator;
 
    protected:  // Internal typedefs
     typedef pointer* map_pointer;
     typedef simple_alloc<value_type, Alloc> data_allocator;
     typedef simple_alloc<pointer, Alloc> map_allocator;
 
-    static size_type buffer_size() {
-        return __deque_buf_size(BufSiz, sizeof(value_type));
-    }
+    typedef __deque_buf_traits<T, BufSiz> buf_traits;
+    static size_type buffer_size() { return buf_traits::value; }
     static size_type initial_map_size() { return 8; }
+    enum { max_spare_nodes = 1 };  //每端最多保留的备用缓冲区个数
 
    protected:  // Data members
     iterator start;
@@ -149,9 +337,24 @@ class deque {
    public:  // Basic accessors
     iterator begin() { return start; }
     iterator end() { return finish; }
-
-    reference operator[](size_type n) { return start[difference_type(n)]; }
+    const_iterator begin() const { return start; }
+    const_iterator end() const { return finish; }
+
+    //缓冲区大小是2的幂时直接算出所在的缓冲区和偏移，不经过迭代器
+    reference operator[](size_type n) {
+        if (buf_traits::pow2) {
+            size_type offset = n + (start.cur - start.first);
+            return start.node[offset >> buf_traits::shift]
+                             [offset & buf_traits::mask];
+        }
+        return start[difference_type(n)];
+    }
     const_reference operator[](size_type n) const {
+        if (buf_traits::pow2) {
+            size_type offset = n + (start.cur - start.first);
+            return start.node[offset >> buf_traits::shift]
+                             [offset & buf_traits::mask];
+        }
         return start[difference_type(n)];
     }
 
@@ -176,13 +379,14 @@ class deque {
     bool empty() const { return finish == start; }
 
    public:  // Constructor, destructor.
-    deque() : start(), finish(), map(0), map_size(0) {
-        create_map_and_nodes(0);
-    }
+    //不配置map和缓冲区，start、finish都是空迭代器，第一次插入时才配置
+    //大量空的stack、queue因此不占用堆内存
+    deque() : start(), finish(), map(0), map_size(0) {}
 
     deque(const deque& x) : start(), finish(), map(0), map_size(0) {
+        if (x.empty()) return;
         create_map_and_nodes(x.size());
-        uninitialized_copy(x.begin(), x.end(), start);
+        TinySTL::uninitialized_copy(x.begin(), x.end(), start);
     }
 
     deque(size_type n, const value_type& value)
@@ -224,15 +428,15 @@ class deque {
     }
 
     void swap(deque& x) {
-        __STD::swap(start, x.start);
-        __STD::swap(finish, x.finish);
-        __STD::swap(map, x.map);
-        __STD::swap(map_size, x.map_size);
+        std::swap(start, x.start);
+        std::swap(finish, x.finish);
+        std::swap(map, x.map);
+        std::swap(map_size, x.map_size);
     }
 
    public:  // push_* and pop_*
     void push_back(const value_type& t) {
-        if (finish.cur != finish.last - 1) {
+        if (finish.last - finish.cur > 1) {  //尚未配置时两者都为0
             construct(finish.cur, t);
             ++finish.cur;
         } else
@@ -323,6 +527,16 @@ class deque {
 
     iterator erase(iterator first, iterator last);
     void clear();
+    //释放两端缓存的备用缓冲区，空deque连map和缓冲区一起释放
+    void shrink_to_fit() {
+        if (empty()) {
+            destroy_map_and_nodes();
+            start = finish = iterator();
+            map = 0;
+            map_size = 0;
+        } else
+            trim_spare_nodes(0);
+    }
 
    protected:  // Internal construction/destruction
     void create_map_and_nodes(size_type num_elements);
@@ -338,17 +552,26 @@ class deque {
     iterator insert_aux(iterator pos, const value_type& x);
     void insert_aux(iterator pos, size_type n, const value_type& x);
 
+    template <class InputIterator>
+    void insert(iterator pos, InputIterator first, InputIterator last,
+                input_iterator_tag);
+    template <class ForwardIterator>
+    void insert(iterator pos, ForwardIterator first, ForwardIterator last,
+                forward_iterator_tag);
+
     template <class ForwardIterator>
     void insert_aux(iterator pos, ForwardIterator first, ForwardIterator last,
                     size_type n);
 
     iterator reserve_elements_at_front(size_type n) {
+        if (map == 0) create_map_and_nodes(0);
         size_type vacancies = start.cur - start.first;
         if (n > vacancies) new_elements_at_front(n - vacancies);
         return start - difference_type(n);
     }
 
     iterator reserve_elements_at_back(size_type n) {
+        if (map == 0) create_map_and_nodes(0);
         size_type vacancies = (finish.last - finish.cur) - 1;
         if (n > vacancies) new_elements_at_back(n - vacancies);
         return finish + difference_type(n);
@@ -381,6 +604,54 @@ class deque {
         data_allocator::deallocate(n, buffer_size());
     }
 
+   protected:  // Spare buffers
+    //弹出后空出的缓冲区不立即释放，留在map中紧挨着start.node之前或
+    //finish.node之后，下次在该端扩张时直接复用；map中其余空位都是0
+    //在一端扩张而该端没有备用时，挪用另一端最外侧的备用缓冲区，
+    //这样先进先出的用法也能循环使用同一批缓冲区
+
+    //在map的slot上放一个缓冲区，slot必须在start.node之前或finish.node之后
+    void fill_node_slot(map_pointer slot, bool at_back) {
+        if (*slot) return;  //已有备用缓冲区
+        pointer p = at_back ? take_front_spare() : take_back_spare();
+        *slot = p ? p : allocate_node();
+    }
+    pointer take_front_spare() {
+        size_type i = start.node - map, n = 0;
+        while (n < i && map[i - n - 1]) ++n;
+        if (n == 0) return 0;
+        pointer p = map[i - n];
+        map[i - n] = 0;
+        return p;
+    }
+    pointer take_back_spare() {
+        size_type i = finish.node - map, n = 0;
+        while (i + n + 1 < map_size && map[i + n + 1]) ++n;
+        if (n == 0) return 0;
+        pointer p = map[i + n];
+        map[i + n] = 0;
+        return p;
+    }
+    //每端只保留keep个备用缓冲区，多余的释放
+    void trim_front_spares(size_type keep) {
+        difference_type i = (start.node - map) - 1 - difference_type(keep);
+        for (; i >= 0 && map[i]; --i) {
+            deallocate_node(map[i]);
+            map[i] = 0;
+        }
+    }
+    void trim_back_spares(size_type keep) {
+        size_type i = (finish.node - map) + 1 + keep;
+        for (; i < map_size && map[i]; ++i) {
+            deallocate_node(map[i]);
+            map[i] = 0;
+        }
+    }
+    void trim_spare_nodes(size_type keep) {
+        trim_front_spares(keep);
+        trim_back_spares(keep);
+    }
+
    public:
     bool operator==(const deque<T, Alloc, 0>& x) const {
         return size() == x.size() && equal(begin(), end(), x.begin());
@@ -389,7 +660,8 @@ class deque {
         return size() != x.size() || !equal(begin(), end(), x.begin());
     }
     bool operator<(const deque<T, Alloc, 0>& x) const {
-        return lexicographical_compare(begin(), end(), x.begin(), x.end());
+        return std::lexicographical_compare(begin(), end(), x.begin(),
+                                            x.end());
     }
 };
 
@@ -400,16 +672,17 @@ void deque<T, Alloc, BufSize>::fill_initialize(size_type n,
     create_map_and_nodes(n);  //创建map
     map_pointer cur;
     for (cur = start.node; cur < finish.node; ++cur)
-        uninitialized_fill(*cur, *cur + buffer_size(), value);
-    uninitialized_fill(finish.first, finish.cur, value);
+        TinySTL::uninitialized_fill(*cur, *cur + buffer_size(), value);
+    TinySTL::uninitialized_fill(finish.first, finish.cur, value);
 }
 
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::create_map_and_nodes(size_type num_elements) {
     size_type num_nodes = num_elements / buffer_size() + 1;
 
-    map_size = max(initial_map_size(), num_nodes + 2);
+    map_size = std::max(initial_map_size(), num_nodes + 2);
     map = map_allocator::allocate(map_size);
+    std::fill(map, map + map_size, pointer(0));
 
     map_pointer nstart = map + (map_size - num_nodes) / 2;
     map_pointer nfinish = nstart + num_nodes - 1;
@@ -423,11 +696,26 @@ void deque<T, Alloc, BufSize>::create_map_and_nodes(size_type num_elements) {
     finish.cur = finish.first + num_elements % buffer_size();
 }
 
+//析构函数调用，元素已析构，释放所有缓冲区和map
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::destroy_map_and_nodes() {
+    if (map == 0) return;  //默认构造后从未插入
+    trim_spare_nodes(0);
+    for (map_pointer cur = start.node; cur <= finish.node; ++cur)
+        deallocate_node(*cur);
+    map_allocator::deallocate(map, map_size);
+}
+
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::push_back_aux(const value_type& t) {
+    if (map == 0) {  //第一次插入，配置好之后走正常路径
+        create_map_and_nodes(0);
+        push_back(t);
+        return;
+    }
     value_type t_copy = t;
     reserve_map_at_back();
-    *(finish.node + 1) = allocate_node();
+    fill_node_slot(finish.node + 1, true);
     construct(finish.cur, t_copy);
     finish.set_node(finish.node + 1);
     finish.cur = finish.first;
@@ -436,9 +724,14 @@ void deque<T, Alloc, BufSize>::push_back_aux(const value_type& t) {
 // Called only if start.cur == start.first.
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::push_front_aux(const value_type& t) {
+    if (map == 0) {
+        create_map_and_nodes(0);
+        push_front(t);
+        return;
+    }
     value_type t_copy = t;
     reserve_map_at_front();
-    *(start.node - 1) = allocate_node();
+    fill_node_slot(start.node - 1, false);
     start.set_node(start.node - 1);
     start.cur = start.last - 1;
     construct(start.cur, t_copy);
@@ -447,10 +740,10 @@ void deque<T, Alloc, BufSize>::push_front_aux(const value_type& t) {
 // Called only if finish.cur == finish.first.
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::pop_back_aux() {
-    deallocate_node(finish.first);
-    finish.set_node(finish.node - 1);
+    finish.set_node(finish.node - 1);  //原来的缓冲区留作备用
     finish.cur = finish.last - 1;
     destroy(finish.cur);
+    trim_back_spares(max_spare_nodes);
 }
 
 // Called only if start.cur == start.last - 1.  Note that if the deque
@@ -460,13 +753,21 @@ void deque<T, Alloc, BufSize>::pop_back_aux() {
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::pop_front_aux() {
     destroy(start.cur);
-    deallocate_node(start.first);
-    start.set_node(start.node + 1);
+    start.set_node(start.node + 1);  //原来的缓冲区留作备用
     start.cur = start.first;
+    trim_front_spares(max_spare_nodes);
 }
 template <class T, class Alloc, size_t BufSize>
 void deque<T, Alloc, BufSize>::reallocate_map(size_type nodes_to_add,
                                               bool add_at_front) {
+    //先摘下备用缓冲区，搬移后map中其余位置清0，再挂回要扩张的一端
+    //插入中途抛出异常时一端可能留下多于max_spare_nodes个，先释放多余的
+    trim_spare_nodes(max_spare_nodes);
+    pointer spares[2 * max_spare_nodes];
+    size_type num_spares = 0;
+    for (pointer p; (p = take_front_spare()) || (p = take_back_spare());)
+        spares[num_spares++] = p;
+
     size_type old_num_nodes = finish.node - start.node + 1;
     size_type new_num_nodes = old_num_nodes + nodes_to_add;
 
@@ -475,17 +776,29 @@ void deque<T, Alloc, BufSize>::reallocate_map(size_type nodes_to_add,
         new_nstart = map + (map_size - new_num_nodes) / 2 +
                      (add_at_front ? nodes_to_add : 0);
         if (new_nstart < start.node)
-            copy(start.node, finish.node + 1, new_nstart);
+            std::copy(start.node, finish.node + 1, new_nstart);
         else
-            copy_backward(start.node, finish.node + 1,
-                          new_nstart + old_num_nodes);
+            std::copy_backward(start.node, finish.node + 1,
+                               new_nstart + old_num_nodes);
+        std::fill(map, new_nstart, pointer(0));
+        std::fill(new_nstart + old_num_nodes, map + map_size, pointer(0));
     } else {
-        size_type new_map_size = map_size + max(map_size, nodes_to_add) + 2;
+        size_type new_map_size =
+            map_size + std::max(map_size, nodes_to_add) + 2;
 
-        map_pointer new_map = map_allocator::allocate(new_map_size);
+        map_pointer new_map;
+        try {
+            new_map = map_allocator::allocate(new_map_size);
+        }
+        catch (...) {  //摘下的备用缓冲区已不在map中，释放掉
+            for (size_type i = 0; i < num_spares; ++i)
+                deallocate_node(spares[i]);
+            throw;
+        }
         new_nstart = new_map + (new_map_size - new_num_nodes) / 2 +
                      (add_at_front ? nodes_to_add : 0);
-        copy(start.node, finish.node + 1, new_nstart);
+        std::fill(new_map, new_map + new_map_size, pointer(0));
+        std::copy(start.node, finish.node + 1, new_nstart);
         map_allocator::deallocate(map, map_size);
 
         map = new_map;
@@ -494,27 +807,43 @@ void deque<T, Alloc, BufSize>::reallocate_map(size_type nodes_to_add,
 
     start.set_node(new_nstart);
     finish.set_node(new_nstart + old_num_nodes - 1);
+
+    size_type i = 0;
+    for (; i < num_spares && i < max_spare_nodes && i < nodes_to_add; ++i)
+        if (add_at_front)
+            *(start.node - 1 - i) = spares[i];
+        else
+            *(finish.node + 1 + i) = spares[i];
+    for (; i < num_spares; ++i) deallocate_node(spares[i]);
 }
 
+//在前端配置足够的缓冲区以容纳new_elements个元素
 template <class T, class Alloc, size_t BufSize>
-void deque<T, Alloc, BufSize>::clear() {
-    for (map_pointer node = start.node + 1; node < finish.node; ++node) {
-        destroy(*node, *node + buffer_size());
-        data_allocator::deallocate(*node, buffer_size());
-    }
+void deque<T, Alloc, BufSize>::new_elements_at_front(size_type new_elements) {
+    size_type new_nodes = (new_elements + buffer_size() - 1) / buffer_size();
+    reserve_map_at_front(new_nodes);
+    for (size_type i = 1; i <= new_nodes; ++i)
+        fill_node_slot(start.node - i, false);
+}
 
-    if (start.node != finish.node) {
-        destroy(start.cur, start.last);
-        destroy(finish.first, finish.cur);
-        data_allocator::deallocate(finish.first, buffer_size());
-    } else
-        destroy(start.cur, finish.cur);
+//在尾端配置足够的缓冲区以容纳new_elements个元素
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::new_elements_at_back(size_type new_elements) {
+    size_type new_nodes = (new_elements + buffer_size() - 1) / buffer_size();
+    reserve_map_at_back(new_nodes);
+    for (size_type i = 1; i <= new_nodes; ++i)
+        fill_node_slot(finish.node + i, true);
+}
 
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::clear() {
+    destroy(start, finish);
     finish = start;
+    trim_spare_nodes(max_spare_nodes);
 }
 
 template <class T, class Alloc, size_t BufSize>
-deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::erase(
+typename deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::erase(
     iterator first, iterator last) {
     if (first == start && last == finish) {
         clear();
@@ -526,22 +855,62 @@ deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::erase(
             copy_backward(start, first, last);
             iterator new_start = start + n;
             destroy(start, new_start);
-            for (map_pointer cur = start.node; cur < new_start.node; ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
             start = new_start;
+            trim_spare_nodes(max_spare_nodes);
         } else {
             copy(last, finish, first);
             iterator new_finish = finish - n;
             destroy(new_finish, finish);
-            for (map_pointer cur = new_finish.node + 1; cur <= finish.node;
-                 ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
             finish = new_finish;
+            trim_spare_nodes(max_spare_nodes);
         }
         return start + elems_before;
     }
 }
 
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::insert(iterator pos, size_type n,
+                                      const value_type& x) {
+    if (pos.cur == start.cur) {
+        iterator new_start = reserve_elements_at_front(n);
+        TinySTL::uninitialized_fill(new_start, start, x);
+        start = new_start;
+    } else if (pos.cur == finish.cur) {
+        iterator new_finish = reserve_elements_at_back(n);
+        TinySTL::uninitialized_fill(finish, new_finish, x);
+        finish = new_finish;
+    } else
+        insert_aux(pos, n, x);
+}
+
+template <class T, class Alloc, size_t BufSize>
+template <class InputIterator>
+void deque<T, Alloc, BufSize>::insert(iterator pos, InputIterator first,
+                                      InputIterator last, input_iterator_tag) {
+    for (; first != last; ++first) {
+        pos = insert(pos, *first);
+        ++pos;
+    }
+}
+
+template <class T, class Alloc, size_t BufSize>
+template <class ForwardIterator>
+void deque<T, Alloc, BufSize>::insert(iterator pos, ForwardIterator first,
+                                      ForwardIterator last,
+                                      forward_iterator_tag) {
+    size_type n = TinySTL::distance(first, last);
+    if (pos.cur == start.cur) {
+        iterator new_start = reserve_elements_at_front(n);
+        TinySTL::uninitialized_copy(first, last, new_start);
+        start = new_start;
+    } else if (pos.cur == finish.cur) {
+        iterator new_finish = reserve_elements_at_back(n);
+        TinySTL::uninitialized_copy(first, last, finish);
+        finish = new_finish;
+    } else
+        insert_aux(pos, first, last, n);
+}
+
 template <class T, class Alloc, size_t BufSize>
 typename deque<T, Alloc, BufSize>::iterator
 deque<T, Alloc, BufSize>::insert_aux(iterator pos, const value_type& x) {
@@ -582,7 +951,7 @@ void deque<T, Alloc, BufSize>::insert_aux(iterator pos, size_type n,
         pos = start + elems_before;
         if (elems_before >= difference_type(n)) {
             iterator start_n = start + difference_type(n);
-            uninitialized_copy(start, start_n, new_start);
+            TinySTL::uninitialized_copy(start, start_n, new_start);
             start = new_start;
             copy(start_n, pos, old_start);
             fill(pos - difference_type(n), pos, x_copy);
@@ -599,7 +968,7 @@ void deque<T, Alloc, BufSize>::insert_aux(iterator pos, size_type n,
         pos = finish - elems_after;
         if (elems_after > difference_type(n)) {
             iterator finish_n = finish - difference_type(n);
-            uninitialized_copy(finish_n, finish, finish);
+            TinySTL::uninitialized_copy(finish_n, finish, finish);
             finish = new_finish;
             copy_backward(pos, finish_n, old_finish);
             fill(pos, pos + difference_type(n), x_copy);
@@ -624,16 +993,16 @@ void deque<T, Alloc, BufSize>::insert_aux(iterator pos, ForwardIterator first,
         pos = start + elems_before;
         if (elems_before >= difference_type(n)) {
             iterator start_n = start + difference_type(n);
-            uninitialized_copy(start, start_n, new_start);
+            TinySTL::uninitialized_copy(start, start_n, new_start);
             start = new_start;
             copy(start_n, pos, old_start);
-            copy(first, last, pos - difference_type(n));
+            std::copy(first, last, pos - difference_type(n));
         } else {
             ForwardIterator mid = first;
-            advance(mid, difference_type(n) - elems_before);
+            TinySTL::advance(mid, difference_type(n) - elems_before);
             __uninitialized_copy_copy(start, pos, first, mid, new_start);
             start = new_start;
-            copy(mid, last, old_start);
+            std::copy(mid, last, old_start);
         }
     } else {
         iterator new_finish = reserve_elements_at_back(n);
@@ -643,16 +1012,16 @@ void deque<T, Alloc, BufSize>::insert_aux(iterator pos, ForwardIterator first,
         pos = finish - elems_after;
         if (elems_after > difference_type(n)) {
             iterator finish_n = finish - difference_type(n);
-            uninitialized_copy(finish_n, finish, finish);
+            TinySTL::uninitialized_copy(finish_n, finish, finish);
             finish = new_finish;
             copy_backward(pos, finish_n, old_finish);
-            copy(first, last, pos);
+            std::copy(first, last, pos);
         } else {
             ForwardIterator mid = first;
-            advance(mid, elems_after);
+            TinySTL::advance(mid, elems_after);
             __uninitialized_copy_copy(mid, last, pos, finish, finish);
             finish = new_finish;
-            copy(first, mid, pos);
+            std::copy(first, mid, pos);
         }
     }
 }
@@ -0,0 +1,235 @@
+#ifndef FLATTREE_H__
+#define FLATTREE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "Alloc.h"
+#include "Function.h"
+#include "Iterator.h"
+#include "Vector.h"
+
+namespace TinySTL {
+
+//按键排好序的vector，键唯一，是flat_map和flat_set的底层
+//元素连续存放，没有节点指针，查找是对数组二分，遍历是顺序读内存；
+//单个插入删除要搬动后面的元素，是O(n)的，适合建好以后读多写少的场合
+//插入删除使所有迭代器失效
+template <class Key, class Value, class KeyOfValue, class Compare,
+          class Alloc = alloc>
+class flat_tree {
+   public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+   protected:
+    typedef vector<Value, Alloc> rep_type;
+
+    //按键比较两个元素，给排序和归并用
+    struct value_less {
+        Compare comp;
+        explicit value_less(const Compare& c) : comp(c) {}
+        bool operator()(const Value& x, const Value& y) const {
+            return comp(KeyOfValue()(x), KeyOfValue()(y));
+        }
+    };
+
+    rep_type c;
+    Compare key_compare;
+
+    static const Key& key(const Value& x) { return KeyOfValue()(x); }
+
+    //无分支的二分：每轮把区间缩小一半，条件只决定base是否前移，
+    //编译成条件传送，不会因为分支预测失败而清空流水线
+    const_pointer __lower_bound(const Key& k) const {
+        const_pointer base = c.begin();
+        size_type n = c.size();
+        if (n == 0) return base;
+        while (n > 1) {
+            size_type half = n / 2;
+            base = key_compare(key(base[half]), k) ? base + half : base;
+            n -= half;
+        }
+        return base + key_compare(key(*base), k);
+    }
+    const_pointer __upper_bound(const Key& k) const {
+        const_pointer base = c.begin();
+        size_type n = c.size();
+        if (n == 0) return base;
+        while (n > 1) {
+            size_type half = n / 2;
+            base = key_compare(k, key(base[half])) ? base : base + half;
+            n -= half;
+        }
+        return base + !key_compare(k, key(*base));
+    }
+    iterator mutable_iterator(const_pointer p) {
+        return c.begin() + (p - c.begin());
+    }
+
+    //把[first, last)复制出来按键稳定排序，相等的键只留第一个
+    template <class InputIterator>
+    void __sorted_unique(InputIterator first, InputIterator last,
+                         rep_type& buf) const {
+        for (; first != last; ++first) buf.push_back(*first);
+        value_less less(key_compare);
+        std::stable_sort(buf.begin(), buf.end(), less);
+        iterator out = buf.begin();
+        for (iterator i = buf.begin(); i != buf.end(); ++i)
+            if (out == buf.begin() || less(*(out - 1), *i)) {
+                if (out != i) *out = *i;
+                ++out;
+            }
+        buf.erase(out, buf.end());
+    }
+
+   public:
+    flat_tree(const Compare& comp = Compare()) : key_compare(comp) {}
+
+   public:
+    // accessors:
+    Compare key_comp() const { return key_compare; }
+    iterator begin() { return c.begin(); }
+    const_iterator begin() const { return c.begin(); }
+    iterator end() { return c.end(); }
+    const_iterator end() const { return c.end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+    bool empty() const { return c.empty(); }
+    size_type size() const { return c.size(); }
+    size_type max_size() const { return size_type(-1) / sizeof(Value); }
+    size_type capacity() const { return c.capacity(); }
+    void reserve(size_type n) { c.reserve(n); }
+
+    void swap(flat_tree& t) {
+        c.swap(t.c);
+        std::swap(key_compare, t.key_compare);
+    }
+
+   public:
+    // insert/erase
+    std::pair<iterator, bool> insert_unique(const value_type& v) {
+        iterator i = mutable_iterator(__lower_bound(key(v)));
+        if (i != end() && !key_compare(key(v), key(*i)))
+            return std::pair<iterator, bool>(i, false);
+        return std::pair<iterator, bool>(c.insert(i, v), true);
+    }
+    //位置正好在v的前后两个元素之间时不用再查找
+    iterator insert_unique(const_iterator position, const value_type& v) {
+        if ((position == end() || key_compare(key(v), key(*position))) &&
+            (position == begin() || key_compare(key(*(position - 1)), key(v))))
+            return c.insert(mutable_iterator(position), v);
+        return insert_unique(v).first;
+    }
+    //整批插入：新元素排序去重后和原有元素线性归并，已有的键保持不变
+    //空表时就是O(n log n)的排序建表
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last);
+
+    void erase(const_iterator position) {
+        c.erase(mutable_iterator(position));
+    }
+    size_type erase(const key_type& k) {
+        const_iterator i = find(k);
+        if (i == end()) return 0;
+        erase(i);
+        return 1;
+    }
+    void erase(const_iterator first, const_iterator last) {
+        c.erase(mutable_iterator(first), mutable_iterator(last));
+    }
+    void clear() { c.clear(); }
+
+   public:
+    // set operations:
+    iterator find(const key_type& k) {
+        return mutable_iterator(((const flat_tree*)this)->find(k));
+    }
+    const_iterator find(const key_type& k) const {
+        const_iterator i = __lower_bound(k);
+        return i == end() || key_compare(k, key(*i)) ? end() : i;
+    }
+    size_type count(const key_type& k) const { return find(k) != end(); }
+    iterator lower_bound(const key_type& k) {
+        return mutable_iterator(__lower_bound(k));
+    }
+    const_iterator lower_bound(const key_type& k) const {
+        return __lower_bound(k);
+    }
+    iterator upper_bound(const key_type& k) {
+        return mutable_iterator(__upper_bound(k));
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        return __upper_bound(k);
+    }
+    std::pair<iterator, iterator> equal_range(const key_type& k) {
+        return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& k) const {
+        return std::pair<const_iterator, const_iterator>(lower_bound(k),
+                                                         upper_bound(k));
+    }
+};
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+template <class InputIterator>
+void flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(
+    InputIterator first, InputIterator last) {
+    rep_type buf;
+    __sorted_unique(first, last, buf);
+    if (c.empty()) {  //建表：复制一份去掉push_back留下的空余容量
+        rep_type exact(buf);
+        c.swap(exact);
+        return;
+    }
+    rep_type merged;
+    merged.reserve(c.size() + buf.size());
+    iterator i = c.begin(), j = buf.begin();
+    while (i != c.end() && j != buf.end())
+        if (key_compare(key(*j), key(*i)))
+            merged.push_back(*j++);
+        else {
+            if (!key_compare(key(*i), key(*j))) ++j;  //键已存在，丢弃新的
+            merged.push_back(*i++);
+        }
+    for (; i != c.end(); ++i) merged.push_back(*i);
+    for (; j != buf.end(); ++j) merged.push_back(*j);
+    c.swap(merged);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+inline bool operator==(
+    const flat_tree<Key, Value, KeyOfValue, Compare, Alloc>& x,
+    const flat_tree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
+    return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+inline bool operator<(
+    const flat_tree<Key, Value, KeyOfValue, Compare, Alloc>& x,
+    const flat_tree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
+    return std::lexicographical_compare(x.begin(), x.end(), y.begin(),
+                                        y.end());
+}
+
+}  // namespace TinySTL
+
+#endif
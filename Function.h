@@ -0,0 +1,45 @@
+#ifndef FUNCTION_H__
+#define FUNCTION_H__
+
+namespace TinySTL {
+
+template <class Arg1, class Arg2, class Result>
+struct binary_function {
+    typedef Arg1 first_argument_type;
+    typedef Arg2 second_argument_type;
+    typedef Result result_type;
+};
+
+// set的KeyOfValue：元素本身就是键
+//接受任意类型，传入可转换的元素时不会生成临时对象
+template <class T>
+struct identity {
+    template <class U>
+    const U& operator()(const U& x) const {
+        return x;
+    }
+};
+
+// map的KeyOfValue：取pair的first
+//同样接受任意pair，例如pair<Key, T>而不只是pair<const Key, T>
+template <class Pair>
+struct select1st {
+    template <class P>
+    const typename P::first_type& operator()(const P& x) const {
+        return x.first;
+    }
+};
+
+//透明的小于比较，两边可以是不同的类型，有is_transparent，
+//用作map/set的比较器时可以不构造键直接查找，相当于C++14的std::less<>
+struct transparent_less {
+    typedef void is_transparent;
+    template <class T, class U>
+    bool operator()(const T& x, const U& y) const {
+        return x < y;
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
@@ -0,0 +1,598 @@
+#ifndef HASHTABLE_H__
+#define HASHTABLE_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Iterator.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TinySTL {
+
+//开放寻址哈希表的控制字节，每个槽一个
+//空和已删除的最高位是1，有元素时存哈希值的低7位，哨兵放在最后一个槽之后
+enum __hash_ctrl {
+    __hash_empty = -128,
+    __hash_deleted = -2,
+    __hash_sentinel = -1
+};
+
+//一组控制字节的比较结果，每个槽占(1 << Shift)位，有效的是每段的最高位
+template <int Shift>
+struct __hash_bitmask {
+    unsigned long long mask;
+
+    explicit __hash_bitmask(unsigned long long m) : mask(m) {}
+    operator bool() const { return mask != 0; }
+    int lowest() const { return __builtin_ctzll(mask) >> Shift; }
+    void clear_lowest() { mask &= mask - 1; }
+    //从组首、组尾数连续没有置位的槽数，mask不能为0
+    int trailing_zeros() const { return __builtin_ctzll(mask) >> Shift; }
+    int leading_zeros(int width) const {
+        return (__builtin_clzll(mask) - (64 - (width << Shift))) >> Shift;
+    }
+};
+
+#if defined(__SSE2__)
+//一组16个控制字节，一条比较指令同时判断16个槽
+struct __hash_group {
+    enum { width = 16 };
+    typedef __hash_bitmask<0> bitmask;
+
+    __m128i ctrl;
+
+    explicit __hash_group(const signed char* p)
+        : ctrl(_mm_loadu_si128((const __m128i*)p)) {}
+    bitmask match(signed char h2) const {
+        return bitmask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2),
+                                                        ctrl)));
+    }
+    bitmask match_empty() const { return match(__hash_empty); }
+    //空和已删除都小于哨兵-1
+    bitmask match_empty_or_deleted() const {
+        return bitmask(_mm_movemask_epi8(
+            _mm_cmpgt_epi8(_mm_set1_epi8(__hash_sentinel), ctrl)));
+    }
+    //组首连续的空槽或已删除槽数，遍历时用来跳过
+    int count_leading_empty_or_deleted() const {
+        unsigned long long m = match_empty_or_deleted().mask;
+        return __builtin_ctzll(~m);
+    }
+};
+#else
+//没有SSE2时一组8个控制字节装进一个64位整数，按位运算同时判断
+// match可能有假阳性，调用者总会再比较键，不影响正确性
+struct __hash_group {
+    enum { width = 8 };
+    typedef __hash_bitmask<3> bitmask;
+
+    static const unsigned long long lsbs = 0x0101010101010101ULL;
+    static const unsigned long long msbs = 0x8080808080808080ULL;
+
+    unsigned long long ctrl;
+
+    explicit __hash_group(const signed char* p) {
+        memcpy(&ctrl, p, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl = __builtin_bswap64(ctrl);
+#endif
+    }
+    bitmask match(signed char h2) const {
+        unsigned long long x = ctrl ^ (lsbs * (unsigned char)h2);
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+    // 0x80的第1位是0，0xFE和0xFF的第1位是1
+    bitmask match_empty() const {
+        return bitmask(ctrl & (~ctrl << 6) & msbs);
+    }
+    // 0x80和0xFE的第0位是0，哨兵0xFF的第0位是1
+    bitmask match_empty_or_deleted() const {
+        return bitmask(ctrl & (~ctrl << 7) & msbs);
+    }
+    int count_leading_empty_or_deleted() const {
+        unsigned long long m = ~match_empty_or_deleted().mask & msbs;
+        return m ? __builtin_ctzll(m) >> 3 : width;
+    }
+};
+#endif
+
+//容量为0的表都指向这一组：哨兵后面全是空，查找不用特判
+template <class Dummy>
+struct __hash_empty_group {
+    static const signed char ctrl[16];
+};
+template <class Dummy>
+const signed char __hash_empty_group<Dummy>::ctrl[16] = {
+    __hash_sentinel, __hash_empty, __hash_empty, __hash_empty,
+    __hash_empty,    __hash_empty, __hash_empty, __hash_empty,
+    __hash_empty,    __hash_empty, __hash_empty, __hash_empty,
+    __hash_empty,    __hash_empty, __hash_empty, __hash_empty};
+
+//按组探测的序列：第i次前进i组，容量加1是2的幂时能走遍所有组
+struct __hash_probe_seq {
+    size_t mask, offset, index;
+
+    __hash_probe_seq(size_t hash, size_t m)
+        : mask(m), offset(hash & m), index(0) {}
+    size_t at(int i) const { return (offset + i) & mask; }
+    void next() {
+        index += __hash_group::width;
+        offset = (offset + index) & mask;
+    }
+};
+
+//前向迭代器，依次访问有元素的槽，遇到末尾的哨兵停下
+template <class Value, class Ref, class Ptr>
+struct __hashtable_iterator {
+    typedef forward_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef Ref reference;
+    typedef Ptr pointer;
+    typedef ptrdiff_t difference_type;
+    typedef __hashtable_iterator<Value, Value&, Value*> iterator;
+    typedef __hashtable_iterator<Value, const Value&, const Value*>
+        const_iterator;
+    typedef __hashtable_iterator<Value, Ref, Ptr> self;
+
+    const signed char* ctrl;
+    Value* slot;
+
+    __hashtable_iterator() : ctrl(0), slot(0) {}
+    __hashtable_iterator(const signed char* c, Value* s) : ctrl(c), slot(s) {}
+    __hashtable_iterator(const iterator& it) : ctrl(it.ctrl), slot(it.slot) {}
+
+    reference operator*() const { return *slot; }
+    pointer operator->() const { return &(operator*()); }
+
+    void skip_empty_or_deleted() {
+        while (*ctrl < __hash_sentinel) {
+            int n = __hash_group(ctrl).count_leading_empty_or_deleted();
+            ctrl += n;
+            slot += n;
+        }
+    }
+    self& operator++() {
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const const_iterator& x) const { return ctrl == x.ctrl; }
+    bool operator!=(const const_iterator& x) const { return ctrl != x.ctrl; }
+};
+
+//开放寻址的哈希表，键唯一，是unordered_map和unordered_set的底层
+//元素直接放在槽数组里，另有一个控制字节数组，容量是2的幂减1；
+//哈希值高位决定从哪一组开始探测，低7位存进控制字节，
+//查找时一次比较一组控制字节，只有低7位相同的槽才去比较键
+//插入可能整体重新散列，使所有迭代器失效；删除只使被删元素的迭代器失效
+template <class Key, class Value, class KeyOfValue, class HashFcn,
+          class EqualKey, class Alloc = alloc>
+class hashtable {
+   public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef HashFcn hasher;
+    typedef EqualKey key_equal;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef __hashtable_iterator<value_type, reference, pointer> iterator;
+    typedef __hashtable_iterator<value_type, const_reference, const_pointer>
+        const_iterator;
+
+   protected:
+    typedef simple_alloc<signed char, Alloc> ctrl_allocator;
+    typedef simple_alloc<value_type, Alloc> slot_allocator;
+    enum { width = __hash_group::width };
+
+    signed char* ctrl;  //容量+width个字节：控制字节、哨兵、前width-1个的副本
+    value_type* slots;
+    size_type capacity;  // 0或2的幂减1
+    size_type num_elements;
+    size_type growth_left;  //不重新散列还能占用的空槽数
+    float mlf;
+    hasher hash;
+    key_equal equals;
+
+    static const Key& key(const value_type& v) { return KeyOfValue()(v); }
+    //标准库对整数的哈希是恒等映射，高低位都要用到，先打散
+    size_t hash_of(const Key& k) const {
+        unsigned long long h = hash(k);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return (size_t)h;
+    }
+    static size_t h1(size_t h) { return h >> 7; }
+    static signed char h2(size_t h) { return (signed char)(h & 0x7f); }
+
+    //同时写控制字节和它在末尾的副本
+    void set_ctrl(size_type i, signed char h) {
+        ctrl[i] = h;
+        ctrl[((i - (width - 1)) & capacity) + ((width - 1) & capacity)] = h;
+    }
+    size_type growth_of(size_type cap) const {
+        size_type g = size_type(cap * mlf);
+        return g < cap ? g : cap - 1;  //至少留一个空槽，探测才会停
+    }
+    //探测序列上第一个空槽或已删除的槽
+    size_type find_first_non_full(size_t h) const {
+        __hash_probe_seq seq(h1(h), capacity);
+        while (true) {
+            __hash_group g(ctrl + seq.offset);
+            __hash_group::bitmask m = g.match_empty_or_deleted();
+            if (m) return seq.at(m.lowest());
+            seq.next();
+        }
+    }
+    //能放下n个元素的最小容量
+    size_type capacity_for(size_type n) const {
+        size_type cap = width - 1;
+        while (growth_of(cap) < n) cap = cap * 2 + 1;
+        return cap;
+    }
+    size_type find_index(const Key& k, size_t h) const;
+    void initialize(size_type cap);
+    void resize(size_type new_capacity);
+    void destroy_slots();
+    //为k找一个槽，必要时先扩容或就地清掉已删除标记，返回槽下标
+    size_type prepare_insert(size_t h);
+
+   public:
+    explicit hashtable(size_type n = 0, const hasher& hf = hasher(),
+                       const key_equal& eql = key_equal())
+        : ctrl((signed char*)__hash_empty_group<void>::ctrl),
+          slots(0),
+          capacity(0),
+          num_elements(0),
+          growth_left(0),
+          mlf(0.875f),
+          hash(hf),
+          equals(eql) {
+        if (n) rehash(n);
+    }
+    hashtable(const hashtable& x);
+    ~hashtable() { destroy_slots(); }
+    hashtable& operator=(const hashtable& x) {
+        hashtable tmp(x);
+        swap(tmp);
+        return *this;
+    }
+
+   public:
+    // accessors:
+    hasher hash_funct() const { return hash; }
+    key_equal key_eq() const { return equals; }
+    iterator begin() {
+        iterator it(ctrl, slots);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator begin() const {
+        return const_cast<hashtable*>(this)->begin();
+    }
+    iterator end() { return iterator(ctrl + capacity, 0); }
+    const_iterator end() const { return const_iterator(ctrl + capacity, 0); }
+    bool empty() const { return num_elements == 0; }
+    size_type size() const { return num_elements; }
+    size_type max_size() const { return size_type(-1) / sizeof(Value); }
+
+    void swap(hashtable& x) {
+        std::swap(ctrl, x.ctrl);
+        std::swap(slots, x.slots);
+        std::swap(capacity, x.capacity);
+        std::swap(num_elements, x.num_elements);
+        std::swap(growth_left, x.growth_left);
+        std::swap(mlf, x.mlf);
+        std::swap(hash, x.hash);
+        std::swap(equals, x.equals);
+    }
+
+   public:
+    // bucket interface:
+    size_type bucket_count() const { return capacity; }
+    float load_factor() const {
+        return capacity ? float(num_elements) / capacity : 0.0f;
+    }
+    float max_load_factor() const { return mlf; }
+    //取值范围(0, 1]，表里已有元素时按新的负载因子重新散列
+    void max_load_factor(float f) {
+        mlf = f;
+        if (capacity) resize(capacity_for(num_elements));
+    }
+    //容量调整到能放下n个元素且不低于当前元素数的最小值
+    void rehash(size_type n);
+    void reserve(size_type n) { rehash(n); }
+
+   public:
+    // insert/erase
+    std::pair<iterator, bool> insert_unique(const value_type& v);
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) insert_unique(*first);
+    }
+
+    void erase(const_iterator position);
+    size_type erase(const key_type& k) {
+        const_iterator it = find(k);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+    void erase(const_iterator first, const_iterator last) {
+        while (first != last) erase(first++);
+    }
+    void clear();
+
+   public:
+    // lookup:
+    iterator find(const key_type& k) {
+        size_type i = find_index(k, hash_of(k));
+        return i == capacity ? end() : iterator(ctrl + i, slots + i);
+    }
+    const_iterator find(const key_type& k) const {
+        return const_cast<hashtable*>(this)->find(k);
+    }
+    size_type count(const key_type& k) const { return find(k) != end(); }
+    std::pair<iterator, iterator> equal_range(const key_type& k) {
+        iterator first = find(k), last = first;
+        if (first != end()) ++last;
+        return std::pair<iterator, iterator>(first, last);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& k) const {
+        const_iterator first = find(k), last = first;
+        if (first != end()) ++last;
+        return std::pair<const_iterator, const_iterator>(first, last);
+    }
+
+   public:
+    // Debugging.
+    bool __hashtable_verify() const;
+};
+
+//元素相同即相等，与顺序无关
+template <class Key, class Value, class KeyOfValue, class HashFcn,
+          class EqualKey, class Alloc>
+bool operator==(
+    const hashtable<Key, Value, KeyOfValue, HashFcn, EqualKey, Alloc>& x,
+    const hashtable<Key, Value, KeyOfValue, HashFcn, EqualKey, Alloc>& y) {
+    if (x.size() != y.size()) return false;
+    typedef typename hashtable<Key, Value, KeyOfValue, HashFcn, EqualKey,
+                               Alloc>::const_iterator const_iterator;
+    for (const_iterator it = x.begin(); it != x.end(); ++it) {
+        const_iterator j = y.find(KeyOfValue()(*it));
+        if (j == y.end() || !(*j == *it)) return false;
+    }
+    return true;
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+hashtable<K, V, KoV, HF, EqK, Al>::hashtable(const hashtable& x)
+    : ctrl((signed char*)__hash_empty_group<void>::ctrl),
+      slots(0),
+      capacity(0),
+      num_elements(0),
+      growth_left(0),
+      mlf(x.mlf),
+      hash(x.hash),
+      equals(x.equals) {
+    if (x.empty()) return;
+    rehash(x.size());
+    //新表里不可能有重复的键，也不会扩容，直接找空槽放
+    try {
+        for (const_iterator it = x.begin(); it != x.end(); ++it) {
+            size_t h = hash_of(key(*it));
+            size_type i = find_first_non_full(h);
+            construct(slots + i, *it);
+            set_ctrl(i, h2(h));
+            ++num_elements;
+            --growth_left;
+        }
+    }
+    catch (...) {
+        destroy_slots();
+        throw;
+    }
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+typename hashtable<K, V, KoV, HF, EqK, Al>::size_type
+hashtable<K, V, KoV, HF, EqK, Al>::find_index(const K& k, size_t h) const {
+    __hash_probe_seq seq(h1(h), capacity);
+    while (true) {
+        __hash_group g(ctrl + seq.offset);
+        for (__hash_group::bitmask m = g.match(h2(h)); m; m.clear_lowest()) {
+            size_type i = seq.at(m.lowest());
+            if (equals(k, key(slots[i]))) return i;
+        }
+        if (g.match_empty()) return capacity;
+        seq.next();
+    }
+}
+
+//分配cap个槽，控制字节全部置空
+//两个数组都分配成功才改动成员，分配失败时表保持原样
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::initialize(size_type cap) {
+    signed char* new_ctrl = ctrl_allocator::allocate(cap + width);
+    value_type* new_slots;
+    try {
+        new_slots = slot_allocator::allocate(cap);
+    }
+    catch (...) {
+        ctrl_allocator::deallocate(new_ctrl, cap + width);
+        throw;
+    }
+    memset(new_ctrl, __hash_empty, cap + width);
+    new_ctrl[cap] = __hash_sentinel;
+    ctrl = new_ctrl;
+    slots = new_slots;
+    capacity = cap;
+    growth_left = growth_of(cap) - num_elements;
+}
+
+//把所有元素搬进容量为new_capacity的新数组，已删除标记随之清除
+//复制元素时抛出异常，表保持原样
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::resize(size_type new_capacity) {
+    signed char* old_ctrl = ctrl;
+    value_type* old_slots = slots;
+    size_type old_capacity = capacity;
+    size_type old_growth_left = growth_left;
+    initialize(new_capacity);
+    size_type i = 0;
+    try {
+        for (; i < old_capacity; ++i)
+            if (old_ctrl[i] >= 0) {
+                size_t h = hash_of(key(old_slots[i]));
+                size_type j = find_first_non_full(h);
+                construct(slots + j, old_slots[i]);
+                set_ctrl(j, h2(h));
+            }
+    }
+    catch (...) {
+        for (size_type j = 0; j < capacity; ++j)
+            if (ctrl[j] >= 0) destroy(slots + j);
+        ctrl_allocator::deallocate(ctrl, capacity + width);
+        slot_allocator::deallocate(slots, capacity);
+        ctrl = old_ctrl;
+        slots = old_slots;
+        capacity = old_capacity;
+        growth_left = old_growth_left;
+        throw;
+    }
+    if (old_capacity) {
+        for (i = 0; i < old_capacity; ++i)
+            if (old_ctrl[i] >= 0) destroy(old_slots + i);
+        ctrl_allocator::deallocate(old_ctrl, old_capacity + width);
+        slot_allocator::deallocate(old_slots, old_capacity);
+    }
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::destroy_slots() {
+    if (!capacity) return;
+    for (size_type i = 0; i < capacity; ++i)
+        if (ctrl[i] >= 0) destroy(slots + i);
+    ctrl_allocator::deallocate(ctrl, capacity + width);
+    slot_allocator::deallocate(slots, capacity);
+    ctrl = (signed char*)__hash_empty_group<void>::ctrl;
+    slots = 0;
+    capacity = 0;
+    num_elements = 0;
+    growth_left = 0;
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::rehash(size_type n) {
+    if (n < num_elements) n = num_elements;
+    if (n == 0)
+        destroy_slots();
+    else if (capacity_for(n) != capacity)
+        resize(capacity_for(n));
+}
+
+//要占用空槽又没有余量时，已删除标记占了一半以上就按原容量重新散列，
+//否则扩容到能再多放一个元素，至少翻倍
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+typename hashtable<K, V, KoV, HF, EqK, Al>::size_type
+hashtable<K, V, KoV, HF, EqK, Al>::prepare_insert(size_t h) {
+    size_type i = find_first_non_full(h);
+    if (growth_left == 0 && ctrl[i] != __hash_deleted) {
+        if (capacity && num_elements * 2 <= growth_of(capacity))
+            resize(capacity);
+        else
+            resize(std::max(capacity * 2 + 1,
+                            capacity_for(num_elements + 1)));
+        i = find_first_non_full(h);
+    }
+    return i;
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+std::pair<typename hashtable<K, V, KoV, HF, EqK, Al>::iterator, bool>
+hashtable<K, V, KoV, HF, EqK, Al>::insert_unique(const value_type& v) {
+    size_t h = hash_of(key(v));
+    size_type i = find_index(key(v), h);
+    if (i != capacity)
+        return std::pair<iterator, bool>(iterator(ctrl + i, slots + i), false);
+    i = prepare_insert(h);
+    construct(slots + i, v);
+    if (ctrl[i] == __hash_empty) --growth_left;
+    set_ctrl(i, h2(h));
+    ++num_elements;
+    return std::pair<iterator, bool>(iterator(ctrl + i, slots + i), true);
+}
+
+//被删的槽前后都有空槽、且中间连续满的槽不到一组时，
+//任何探测都不会在这里越过一个满组，直接置空即可，不留已删除标记
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::erase(const_iterator position) {
+    size_type i = position.ctrl - ctrl;
+    destroy(slots + i);
+    --num_elements;
+    size_type before = (i - width) & capacity;
+    __hash_group::bitmask empty_after = __hash_group(ctrl + i).match_empty();
+    __hash_group::bitmask empty_before =
+        __hash_group(ctrl + before).match_empty();
+    bool never_full = empty_before && empty_after &&
+                      empty_after.trailing_zeros() +
+                              empty_before.leading_zeros(width) <
+                          width;
+    set_ctrl(i, never_full ? __hash_empty : __hash_deleted);
+    if (never_full) ++growth_left;
+}
+
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+void hashtable<K, V, KoV, HF, EqK, Al>::clear() {
+    if (!capacity) return;
+    for (size_type i = 0; i < capacity; ++i)
+        if (ctrl[i] >= 0) destroy(slots + i);
+    memset(ctrl, __hash_empty, capacity + width);
+    ctrl[capacity] = __hash_sentinel;
+    num_elements = 0;
+    growth_left = growth_of(capacity);
+}
+
+//检查副本字节、计数和余量，以及每个元素都能按自己的哈希值找到
+template <class K, class V, class KoV, class HF, class EqK, class Al>
+bool hashtable<K, V, KoV, HF, EqK, Al>::__hashtable_verify() const {
+    if (!capacity) return num_elements == 0 && growth_left == 0;
+    if (ctrl[capacity] != __hash_sentinel) return false;
+    size_type full = 0, deleted = 0;
+    for (size_type i = 0; i < capacity; ++i) {
+        if (i < width - 1 && capacity >= width - 1 &&
+            ctrl[capacity + 1 + i] != ctrl[i])
+            return false;
+        if (ctrl[i] == __hash_deleted)
+            ++deleted;
+        else if (ctrl[i] >= 0) {
+            ++full;
+            size_t h = hash_of(key(slots[i]));
+            if (ctrl[i] != h2(h) || find_index(key(slots[i]), h) != i)
+                return false;
+        }
+    }
+    return full == num_elements &&
+           growth_left + full + deleted == growth_of(capacity);
+}
+
+}  // namespace TinySTL
+
+#endif
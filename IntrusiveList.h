@@ -0,0 +1,174 @@
+#ifndef INTRUSIVELIST_H__
+#define INTRUSIVELIST_H__
+
+#include <cstddef>
+#include "List.h"
+
+namespace TinySTL {
+
+//嵌入到用户对象中的链接钩子
+typedef __list_node_base list_hook;
+
+template <class T, list_hook T::*Hook, class Ref, class Ptr>
+struct __intrusive_list_iterator {
+    typedef __intrusive_list_iterator<T, Hook, T&, T*> iterator;
+    typedef __intrusive_list_iterator<T, Hook, Ref, Ptr> self;
+
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef __list_node_base* base_ptr;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    base_ptr node;  //指向对象中的钩子，end()时指向哨兵
+
+    __intrusive_list_iterator(base_ptr x) : node(x) {}
+    __intrusive_list_iterator() {}
+    __intrusive_list_iterator(const iterator& x) : node(x.node) {}
+
+    //由钩子地址反推对象地址
+    static T* value(base_ptr x) {
+        return (T*)((char*)x - (size_t)&(((T*)0)->*Hook));
+    }
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+    reference operator*() const { return *value(node); }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        node = (base_ptr)(node->next);
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        node = (base_ptr)(node->prev);
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+};
+
+//侵入式链表：直接链接对象中的钩子，不配置也不析构任何东西
+//对象的生命期由用户管理，对象在链表中时不能销毁，也不能同时挂在两个链表上
+template <class T, list_hook T::*Hook>
+class intrusive_list {
+   protected:
+    typedef __list_node_base* base_ptr;
+
+   public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+   public:
+    typedef __intrusive_list_iterator<T, Hook, T&, T*> iterator;
+
+   protected:
+    list_hook sentinel;
+    size_type node_count;
+    base_ptr node() const { return (base_ptr)&sentinel; }
+    void empty_initialize() {
+        sentinel.next = node();
+        sentinel.prev = node();
+        node_count = 0;
+    }
+
+   private:  //对象不属于链表，不允许拷贝
+    intrusive_list(const intrusive_list&);
+    intrusive_list& operator=(const intrusive_list&);
+
+   public:
+    intrusive_list() { empty_initialize(); }
+    ~intrusive_list() { clear(); }
+
+    iterator begin() { return (base_ptr)(sentinel.next); }
+    iterator end() { return node(); }
+    bool empty() const { return sentinel.next == node(); }
+    size_type size() const { return node_count; }
+    reference front() { return *begin(); }
+    reference back() { return *(--end()); }
+
+    //x必须已经在某个intrusive_list<T, Hook>中
+    static iterator iterator_to(reference x) { return &(x.*Hook); }
+
+    iterator insert(iterator position, reference x) {
+        __list_link_before(position.node, &(x.*Hook));
+        ++node_count;
+        return &(x.*Hook);
+    }
+    iterator erase(iterator position) {  //只摘下，不析构
+        base_ptr next_node = base_ptr(position.node->next);
+        __list_unlink(position.node);
+        --node_count;
+        return iterator(next_node);
+    }
+    iterator erase(iterator first, iterator last) {
+        while (first != last) erase(first++);
+        return last;
+    }
+    void remove(reference x) { erase(iterator_to(x)); }
+    void clear() { empty_initialize(); }
+
+    void push_front(reference x) { insert(begin(), x); }
+    void push_back(reference x) { insert(end(), x); }
+    void pop_front() { erase(begin()); }
+    void pop_back() {
+        iterator tmp = end();
+        erase(--tmp);
+    }
+
+    void splice(iterator position, intrusive_list& x) {  // x必须不同
+        if (!x.empty()) {
+            __list_transfer(position.node, x.begin().node, x.end().node);
+            node_count += x.node_count;
+            x.node_count = 0;
+        }
+    }
+    void splice(iterator position, intrusive_list& x, iterator i) {
+        iterator j = i;
+        ++j;
+        if (position == i || position == j) return;
+        __list_transfer(position.node, i.node, j.node);
+        ++node_count;
+        --x.node_count;
+    }
+    void splice(iterator position, intrusive_list& x, iterator first,
+                iterator last) {
+        if (first == last) return;
+        size_type n = 0;
+        if (&x != this)
+            for (iterator i = first; i != last; ++i) ++n;
+        splice(position, x, first, last, n);
+    }
+    void splice(iterator position, intrusive_list& x, iterator first,
+                iterator last, size_type n) {  //给出区间长度，跨链表也是O(1)
+        if (first == last) return;
+        __list_transfer(position.node, first.node, last.node);
+        if (&x != this) {
+            node_count += n;
+            x.node_count -= n;
+        }
+    }
+    void swap(intrusive_list& x) {
+        intrusive_list tmp;
+        tmp.splice(tmp.end(), *this);
+        splice(end(), x);
+        x.splice(x.end(), tmp);
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
@@ -25,7 +25,7 @@ struct iterator {
 
 template <class Iterator>
 struct iterator_traits {
-    typedef typename Iterator::Iterator_category iterator_category;
+    typedef typename Iterator::iterator_category iterator_category;
     typedef typename Iterator::value_type value_type;
     typedef typename Iterator::difference_type difference_type;
     typedef typename Iterator::pointer pointer;
@@ -69,6 +69,54 @@ inline typename iterator_traits<Iterator>::value_type* value_type(
     return static_cast<typename iterator_traits<Iterator>::value_type*>(0);
 };
 
+//计算两个迭代器之间的距离，随机访问迭代器直接相减
+template <class InputIterator>
+inline typename iterator_traits<InputIterator>::difference_type __distance(
+    InputIterator first, InputIterator last, input_iterator_tag) {
+    typename iterator_traits<InputIterator>::difference_type n = 0;
+    for (; first != last; ++first) ++n;
+    return n;
+}
+
+template <class RandomAccessIterator>
+inline typename iterator_traits<RandomAccessIterator>::difference_type
+__distance(RandomAccessIterator first, RandomAccessIterator last,
+           random_iterator_tag) {
+    return last - first;
+}
+
+template <class InputIterator>
+inline typename iterator_traits<InputIterator>::difference_type distance(
+    InputIterator first, InputIterator last) {
+    return __distance(first, last, iterator_category(first));
+}
+
+//将迭代器前进n步，只有双向和随机访问迭代器可以后退
+template <class InputIterator, class Distance>
+inline void __advance(InputIterator& i, Distance n, input_iterator_tag) {
+    while (n--) ++i;
+}
+
+template <class BidirectionalIterator, class Distance>
+inline void __advance(BidirectionalIterator& i, Distance n,
+                      bidirectional_iterator_tag) {
+    if (n >= 0)
+        while (n--) ++i;
+    else
+        while (n++) --i;
+}
+
+template <class RandomAccessIterator, class Distance>
+inline void __advance(RandomAccessIterator& i, Distance n,
+                      random_iterator_tag) {
+    i += n;
+}
+
+template <class InputIterator, class Distance>
+inline void advance(InputIterator& i, Distance n) {
+    __advance(i, n, iterator_category(i));
+}
+
 }  // namespace TinySTL
 
 #endif
\ No newline at end of file
@@ -1,20 +1,71 @@
 #ifndef LIST_H__
 #define LIST_H__
 
+#include <algorithm>
 #include <cstddef>
 #include "Alloc.h"
 #include "Construct.h"
 
 namespace TinySTL {
 
-template <class T>
-struct __list_node {
+struct __list_node_base {
     typedef void* void_pointer;
     void_pointer next;
     void_pointer prev;
+};
+
+template <class T>
+struct __list_node : public __list_node_base {
     T data;
 };
 
+//以下链接操作只处理next/prev，list和intrusive_list共用
+inline void __list_link_before(__list_node_base* position,
+                               __list_node_base* x) {  //把x接到position前
+    x->next = position;
+    x->prev = position->prev;
+    ((__list_node_base*)position->prev)->next = x;
+    position->prev = x;
+}
+
+inline void __list_unlink(__list_node_base* x) {  //把x从所在链表摘下
+    ((__list_node_base*)x->prev)->next = x->next;
+    ((__list_node_base*)x->next)->prev = x->prev;
+}
+
+//将[first,last)移到position前
+inline void __list_transfer(__list_node_base* position,
+                            __list_node_base* first, __list_node_base* last) {
+    if (position != last) {
+        ((__list_node_base*)last->prev)->next = position;
+        ((__list_node_base*)first->prev)->next = last;
+        ((__list_node_base*)position->prev)->next = first;
+        void* tmp = position->prev;
+        position->prev = last->prev;
+        last->prev = first->prev;
+        first->prev = tmp;
+    }
+}
+
+//按节点中的值比较，供sort对节点指针数组排序
+template <class T>
+struct __list_node_less {
+    bool operator()(const __list_node_base* x,
+                    const __list_node_base* y) const {
+        return ((const __list_node<T>*)x)->data <
+               ((const __list_node<T>*)y)->data;
+    }
+};
+
+//POD元素把值连同节点指针一起拷进数组，比较时不再访问节点
+template <class T>
+struct __list_sort_entry {
+    T key;
+    __list_node_base* node;
+
+    bool operator<(const __list_sort_entry& x) const { return key < x.key; }
+};
+
 template <class T, class Ref, class Ptr>
 struct __list_iterator {
     typedef __list_iterator<T, T&, T*> iterator;
@@ -25,22 +76,23 @@ struct __list_iterator {
     typedef Ptr pointer;
     typedef Ref reference;
     typedef __list_node<T>* link_type;
+    typedef __list_node_base* base_ptr;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
 
-    link_type node;
+    base_ptr node;  //可能指向list内嵌的哨兵，只能当作base访问
 
-    __list_iterator(link_type x) : node(x) {}
+    __list_iterator(base_ptr x) : node(x) {}
     __list_iterator() {}
     __list_iterator(const iterator& x) : node(x.node) {}
 
     bool operator==(const self& x) const { return node == x.node; }
     bool operator!=(const self& x) const { return node != x.node; }
-    reference operator*() const { return (*node).data; }
+    reference operator*() const { return ((link_type)node)->data; }
     pointer operator->() const { return &(operator*()); }
 
     self& operator++() {
-        node = (link_type)((*node).next);
+        node = (base_ptr)((*node).next);
         return *this;
     }
     self operator++(int) {
@@ -49,7 +101,7 @@ struct __list_iterator {
         return tmp;
     }
     self& operator--() {
-        node = (link_type)((*node).prev);
+        node = (base_ptr)((*node).prev);
         return *this;
     }
     self operator--(int) {
@@ -64,6 +116,7 @@ class list {
    protected:
     typedef void* void_pointer;
     typedef __list_node<T> list_node;
+    typedef __list_node_base* base_ptr;
     typedef simple_alloc<list_node, Alloc> list_node_allocator;
 
    public:
@@ -96,32 +149,39 @@ class list {
     }
 
    protected:
-    link_type node;
+    __list_node_base sentinel;  //哨兵节点内嵌在list对象中，空链表不分配内存
+    size_type node_count;  //缓存元素个数，size()为O(1)
+    base_ptr node() const { return (base_ptr)&sentinel; }
     void empty_initialize() {  //产生一个空链表
-        node = get_node();
-        node->next = node;
-        node->prev = node;
+        sentinel.next = node();
+        sentinel.prev = node();
+        node_count = 0;
+    }
+    void fill_initialize(size_type n, const T& value) {
+        empty_initialize();
+        insert(begin(), n, value);
     }
 
    public:
     list() { empty_initialize(); }
-
-    iterator begin() { return (link_type)((*node).next); }
-    iterator end() { return node; }
-    bool empty() const { return node->next == node; }
-    size_type size() const {
-        size_type result = 0;
-        distance(begin(), end(), result);
-        return result;
+    list(const list& x) {
+        empty_initialize();
+        insert(begin(), iterator((base_ptr)x.sentinel.next),
+               iterator(x.node()));
     }
+    ~list() { clear(); }
+    list& operator=(const list& x);
+
+    iterator begin() { return (base_ptr)(sentinel.next); }
+    iterator end() { return node(); }
+    bool empty() const { return sentinel.next == node(); }
+    size_type size() const { return node_count; }
     reference front() { return *begin(); }
     reference back() { return *(--end()); }
     iterator insert(iterator position, const T& x) {
         link_type tmp = create_node(x);
-        tmp->next = position.node;
-        tmp->prev = position.node->prev;
-        (link_type(position.node->prev))->next = tmp;
-        position.node->prev = tmp;
+        __list_link_before(position.node, tmp);
+        ++node_count;
         return tmp;
     }
     template <class InputIterator>
@@ -137,17 +197,17 @@ class list {
     void push_front(const T& x) { insert(begin(), x); }
     void push_back(const T& x) { insert(end(), x); }
     iterator erase(iterator position) {
-        link_type next_node = link_type(position.node->next);
-        link_type prev_node = link_type(position.node->prev);
-        prev_node->next = next_node;
-        next_node->prev = prev_node;
-        destroy_node(position.node);
+        base_ptr next_node = base_ptr(position.node->next);
+        __list_unlink(position.node);
+        destroy_node((link_type)position.node);
+        --node_count;
         return iterator(next_node);
     }
     iterator erase(iterator first, iterator last);
     void resize(size_type new_size, const T& x);
     void resize(size_type new_size) { resize(new_size, T()); }
     void clear();
+    void swap(list& x);
 
     void pop_front() { erase(begin()); }
     void pop_back() {
@@ -160,40 +220,63 @@ class list {
     explicit list(size_type n) { fill_initialize(n, T()); }
 
    protected:
+    //只改链接不改计数，跨list搬移时由调用者调整两边的node_count
     void transfer(iterator position, iterator first,
                   iterator last) {  //将[first,last)移到position前
-        if (position != last) {
-            (*(link_type((*last.node).prev))).next = position.node;
-            (*(link_type((*first.node).prev))).next = last.node;
-            (*(link_type((*position.node).prev))).next = first.node;
-            link_type tmp = link_type((*position.node).prev);
-            (*position.node).prev = (*last.node).prev;
-            (*last.node).prev = (*first.node).prev;
-            (*first.node).prev = tmp;
-        }
+        __list_transfer(position.node, first.node, last.node);
     }
 
    public:
     void splice(iterator position, list& x) {  //将x接到position前 x必须不同
-        if (!x.empty()) transfer(position, x.begin(), x.end());
+        if (!x.empty()) {
+            transfer(position, x.begin(), x.end());
+            node_count += x.node_count;
+            x.node_count = 0;
+        }
     }
-    void splice(iterator position, list&,
+    void splice(iterator position, list& x,
                 iterator i) {  //将i所指元素接到position前 可以是同一个list
         iterator j = i;
         ++j;
         if (position == i || position == j) return;
         transfer(position, i, j);
+        ++node_count;
+        --x.node_count;
     }
-    void splice(iterator position, list&, iterator first,
+    void splice(iterator position, list& x, iterator first,
                 iterator last) {  //将区间接到position前 可以是同一个list
                                   //position不能在区间中
-        if (first != last) transfer(position, first, last);
+        if (first == last) return;
+        size_type n = 0;
+        if (&x != this)  //跨list时需要数出区间长度，O(n)
+            for (iterator i = first; i != last; ++i) ++n;
+        splice(position, x, first, last, n);
+    }
+    void splice(iterator position, list& x, iterator first, iterator last,
+                size_type n) {  //调用者给出区间长度n，跨list也是O(1)
+        if (first == last) return;
+        transfer(position, first, last);
+        if (&x != this) {
+            node_count += n;
+            x.node_count -= n;
+        }
     }
     void remove(const T& value);
     void unique();
     void merge(list& x);
     void reverse();
     void sort();
+
+   protected:
+    //超过这个长度后，sort改为在连续数组上排序节点指针
+    static size_type sort_buffer_threshold() { return 4096; }
+    void sort_in_place();
+    void sort_by_buffer() {
+        typedef typename _type_traits<T>::is_POD_type is_POD;
+        sort_by_buffer_aux(is_POD());
+    }
+    void sort_by_buffer_aux(_true_type);
+    void sort_by_buffer_aux(_false_type);
 };
 
 template <class T, class Alloc>
@@ -215,26 +298,41 @@ typename list<T, Alloc>::iterator list<T, Alloc>::erase(iterator first,
 
 template <class T, class Alloc>
 void list<T, Alloc>::resize(size_type new_size, const T& x) {
-    iterator i = begin();
-    size_type len = 0;
-    for (; i != end() && len < new_size; ++i, ++len)
-        ;
-    if (len == new_size)
+    size_type len = size();
+    if (new_size < len) {  //从尾部往回走，只需走被删掉的部分
+        iterator i = end();
+        for (; len > new_size; --len) --i;
         erase(i, end());
-    else  // i == end()
+    } else
         insert(end(), new_size - len, x);
 }
 
+template <class T, class Alloc>
+list<T, Alloc>& list<T, Alloc>::operator=(const list<T, Alloc>& x) {
+    if (this != &x) {
+        list<T, Alloc> tmp(x);
+        swap(tmp);
+    }
+    return *this;
+}
+
 template <class T, class Alloc>
 void list<T, Alloc>::clear() {  //清除所有节点
-    link_type cur = (link_type)node->next;
-    while (cur != node) {
+    link_type cur = (link_type)sentinel.next;
+    while (cur != node()) {
         link_type tmp = cur;
         cur = (link_type)cur->next;
         destroy_node(tmp);
     }
-    node->next = node;
-    node->prev = node;
+    empty_initialize();
+}
+
+template <class T, class Alloc>
+void list<T, Alloc>::swap(list<T, Alloc>& x) {  //哨兵不能交换指针，只能把节点搬过去
+    list<T, Alloc> tmp;
+    tmp.splice(tmp.end(), *this);
+    splice(end(), x);
+    x.splice(x.end(), tmp);
 }
 
 template <class T, class Alloc>
@@ -266,6 +364,7 @@ void list<T, Alloc>::unique() {  //移除数值相同的连续元素
 
 template <class T, class Alloc>
 void list<T, Alloc>::merge(list<T, Alloc>& x) {  //将x合并到自身，两个list必须递增排序
+    if (this == &x) return;  //和自身合并什么也不做，否则计数被清零
     iterator first1 = begin();
     iterator last1 = end();
     iterator first2 = x.begin();
@@ -278,11 +377,14 @@ void list<T, Alloc>::merge(list<T, Alloc>& x) {  //将x合并到自身，两个l
         } else
             ++first1;
     if (first2 != last2) transfer(last1, first2, last2);
+    node_count += x.node_count;
+    x.node_count = 0;
 }
 
 template <class T, class Alloc>
 void list<T, Alloc>::reverse() {  //逆置
-    if (node->next == node || link_type(node->next)->next == node) return;
+    if (sentinel.next == node() || base_ptr(sentinel.next)->next == node())
+        return;
     iterator first = begin();
     ++first;
     while (first != end()) {
@@ -293,8 +395,17 @@ void list<T, Alloc>::reverse() {  //逆置
 }
 
 template <class T, class Alloc>
-void list<T, Alloc>::sort() {   //不能用stl算法 因为其只支持RamdonIterator
-    if (node->next == node || link_type(node->next)->next == node) return;
+void list<T, Alloc>::sort() {
+    if (sentinel.next == node() || base_ptr(sentinel.next)->next == node())
+        return;
+    if (node_count < sort_buffer_threshold())
+        sort_in_place();
+    else
+        sort_by_buffer();
+}
+
+template <class T, class Alloc>
+void list<T, Alloc>::sort_in_place() {  //不能用stl算法 因为其只支持RamdonIterator
     list<T, Alloc> carry;
     list<T, Alloc> counter[64];
     int fill = 0;
@@ -313,6 +424,66 @@ void list<T, Alloc>::sort() {   //不能用stl算法 因为其只支持RamdonIte
     swap(counter[fill - 1]);
 }
 
+//大链表逐节点merge时每一步都是随机访存：先把节点收集到连续数组，
+//在数组上做稳定排序，最后一遍重新链接
+template <class T, class Alloc>
+void list<T, Alloc>::sort_by_buffer_aux(_true_type) {
+    typedef __list_sort_entry<T> entry;
+    typedef simple_alloc<entry, Alloc> buffer_allocator;
+    const size_type n = node_count;
+    entry* buf = buffer_allocator::allocate(n);
+    base_ptr cur = (base_ptr)sentinel.next;
+    for (size_type i = 0; i < n; ++i, cur = (base_ptr)cur->next) {
+        buf[i].key = ((link_type)cur)->data;
+        buf[i].node = cur;
+    }
+
+    try {
+        std::stable_sort(buf, buf + n);
+    }
+    catch (...) {  //还没有改动链接，链表保持原样
+        buffer_allocator::deallocate(buf, n);
+        throw;
+    }
+
+    base_ptr prev = node();
+    for (size_type i = 0; i < n; ++i) {
+        prev->next = buf[i].node;
+        buf[i].node->prev = prev;
+        prev = buf[i].node;
+    }
+    prev->next = node();
+    sentinel.prev = prev;
+    buffer_allocator::deallocate(buf, n);
+}
+
+template <class T, class Alloc>
+void list<T, Alloc>::sort_by_buffer_aux(_false_type) {
+    typedef simple_alloc<base_ptr, Alloc> buffer_allocator;
+    const size_type n = node_count;
+    base_ptr* buf = buffer_allocator::allocate(n);
+    base_ptr cur = (base_ptr)sentinel.next;
+    for (size_type i = 0; i < n; ++i, cur = (base_ptr)cur->next) buf[i] = cur;
+
+    try {  //元素的比较可能抛出异常
+        std::stable_sort(buf, buf + n, __list_node_less<T>());
+    }
+    catch (...) {
+        buffer_allocator::deallocate(buf, n);
+        throw;
+    }
+
+    base_ptr prev = node();
+    for (size_type i = 0; i < n; ++i) {
+        prev->next = buf[i];
+        buf[i]->prev = prev;
+        prev = buf[i];
+    }
+    prev->next = node();
+    sentinel.prev = prev;
+    buffer_allocator::deallocate(buf, n);
+}
+
 }  // namespace TinySTL
 
 #endif
\ No newline at end of file
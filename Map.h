@@ -1,25 +1,44 @@
 #ifndef MAP_H__
 #define MAP_H__
 
+#include <functional>
+#include <tuple>
+#include <utility>
 #include "Alloc.h"
 #include "Construct.h"
+#include "Function.h"
 #include "RB_Tree.h"
 
 namespace TinySTL {
 
-template <class Key, class T, class Compare = std::less<Key>, class Alloc = alloc>
+// NodeBase用__rb_tree_rank_node_base时支持select/rank/distance，见ranked_map
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = alloc, class NodeBase = __rb_tree_node_base>
+class map;
+
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
+bool operator==(const map<Key, T, Compare, Alloc, NodeBase>& x,
+                const map<Key, T, Compare, Alloc, NodeBase>& y);
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
+bool operator<(const map<Key, T, Compare, Alloc, NodeBase>& x,
+               const map<Key, T, Compare, Alloc, NodeBase>& y);
+
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
 class map {
+    template <class, class, class, class, class>
+    friend class map;
+
    public:
     // typedefs:
 
     typedef Key key_type;
     typedef T data_type;
     typedef T mapped_type;
-    typedef pair<const Key, T> value_type;
+    typedef std::pair<const Key, T> value_type;
     typedef Compare key_compare;
 
     class value_compare : public binary_function<value_type, value_type, bool> {
-        friend class map<Key, T, Compare, Alloc>;
+        friend class map<Key, T, Compare, Alloc, NodeBase>;
 
        protected:
         Compare comp;
@@ -33,7 +52,7 @@ class map {
 
    private:
     typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare,
-                    Alloc>
+                    Alloc, NodeBase>
         rep_type;
     rep_type t;  // red-black tree representing map
    public:
@@ -47,12 +66,14 @@ class map {
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::node_type node_type;
 
     // allocation/deallocation
 
     map() : t(Compare()) {}
     explicit map(const Compare& comp) : t(comp) {}
 
+    //区间已排序时O(n)建树，见rb_tree::insert_unique
     template <class InputIterator>
     map(InputIterator first, InputIterator last) : t(Compare()) {
         t.insert_unique(first, last);
@@ -64,9 +85,9 @@ class map {
         t.insert_unique(first, last);
     }
 
-    map(const map<Key, T, Compare, Alloc>& x) : t(x.t) {}
-    map<Key, T, Compare, Alloc>& operator=(
-        const map<Key, T, Compare, Alloc>& x) {
+    map(const map<Key, T, Compare, Alloc, NodeBase>& x) : t(x.t) {}
+    map<Key, T, Compare, Alloc, NodeBase>& operator=(
+        const map<Key, T, Compare, Alloc, NodeBase>& x) {
         t = x.t;
         return *this;
     }
@@ -86,30 +107,92 @@ class map {
     bool empty() const { return t.empty(); }
     size_type size() const { return t.size(); }
     size_type max_size() const { return t.max_size(); }
-    T& operator[](const key_type& k) {
-        return (*((insert(value_type(k, T()))).first)).second;
-    }
-    void swap(map<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+    //键已存在时不构造T()，也不复制元素
+    T& operator[](const key_type& k) { return try_emplace(k).first->second; }
+    void swap(map<Key, T, Compare, Alloc, NodeBase>& x) { t.swap(x.t); }
 
     // insert/erase
 
-    pair<iterator, bool> insert(const value_type& x) {
+    std::pair<iterator, bool> insert(const value_type& x) {
         return t.insert_unique(x);
     }
     iterator insert(iterator position, const value_type& x) {
         return t.insert_unique(position, x);
     }
-    
     template <class InputIterator>
     void insert(InputIterator first, InputIterator last) {
         t.insert_unique(first, last);
     }
 
+    //用args在节点里原地构造元素；要先构造出来才知道键，键已存在时再销毁
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return t.emplace_unique(std::forward<Args>(args)...);
+    }
+    template <class... Args>
+    iterator emplace_hint(iterator position, Args&&... args) {
+        return t.emplace_hint_unique(position, std::forward<Args>(args)...);
+    }
+    //先按k查找，键不存在时才用k和args原地构造元素，否则什么都不做，
+    // args也不会被移走
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+        return t.try_emplace_unique(
+            k, std::piecewise_construct, std::forward_as_tuple(k),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    template <class... Args>
+    iterator try_emplace(iterator position, const key_type& k,
+                         Args&&... args) {
+        return t.try_emplace_hint_unique(
+            position, k, std::piecewise_construct, std::forward_as_tuple(k),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    //键已存在时给second赋值，否则插入；只查找一次
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+        std::pair<iterator, bool> p = try_emplace(k, std::forward<M>(obj));
+        if (!p.second) p.first->second = std::forward<M>(obj);
+        return p;
+    }
+    template <class M>
+    iterator insert_or_assign(iterator position, const key_type& k, M&& obj) {
+        size_type n = size();
+        iterator i = try_emplace(position, k, std::forward<M>(obj));
+        if (size() == n) i->second = std::forward<M>(obj);
+        return i;
+    }
+
     void erase(iterator position) { t.erase(position); }
     size_type erase(const key_type& x) { return t.erase(x); }
     void erase(iterator first, iterator last) { t.erase(first, last); }
     void clear() { t.clear(); }
 
+    //在map之间搬动元素，不配置内存也不复制元素，见rb_tree::extract
+    node_type extract(iterator position) { return t.extract(position); }
+    node_type extract(const key_type& x) { return t.extract(x); }
+    //键已存在时不插入，节点留在nh中
+    std::pair<iterator, bool> insert(node_type&& nh) {
+        return t.insert_unique(std::move(nh));
+    }
+    //键不在本map中的元素移过来，其余留在source中
+    template <class Compare2>
+    void merge(map<Key, T, Compare2, Alloc, NodeBase>& source) {
+        t.merge_unique(source.t);
+    }
+
+    //分裂与连接，O(log n)，见rb_tree::split
+    //键不小于k的元素移到right中，right原有的元素被清除
+    void split(const key_type& k, map& right) { t.split(k, right.t); }
+    void split(iterator position, map& right) { t.split(position, right.t); }
+    // right的键都要大于本map的键，接过来以后right变空
+    void join(map& right) { t.join(right.t); }
+    //集合运算，O(m log(n/m + 1))，见rb_tree::set_union
+    // x的元素都移过来，键已存在的保留本map中的值，x变空
+    void set_union(map& x) { t.set_union(x.t); }
+    void set_intersection(const map& x) { t.set_intersection(x.t); }
+    void set_difference(const map& x) { t.set_difference(x.t); }
+
     // map operations:
 
     iterator find(const key_type& x) { return t.find(x); }
@@ -124,35 +207,87 @@ class map {
         return t.upper_bound(x);
     }
 
-    pair<iterator, iterator> equal_range(const key_type& x) {
+    std::pair<iterator, iterator> equal_range(const key_type& x) {
+        return t.equal_range(x);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& x) const {
+        return t.equal_range(x);
+    }
+
+    //比较器有is_transparent时的异构查找，见rb_tree::find
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator find(const K& x) {
+        return t.find(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator find(const K& x) const {
+        return t.find(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    size_type count(const K& x) const {
+        return t.count(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator lower_bound(const K& x) {
+        return t.lower_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator lower_bound(const K& x) const {
+        return t.lower_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator upper_bound(const K& x) {
+        return t.upper_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator upper_bound(const K& x) const {
+        return t.upper_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& x) {
         return t.equal_range(x);
     }
-    pair<const_iterator, const_iterator> equal_range(const key_type& x) const {
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
         return t.equal_range(x);
     }
-    friend bool operator== __STL_NULL_TMPL_ARGS(const map&, const map&);
-    friend bool operator<__STL_NULL_TMPL_ARGS(const map&, const map&);
+
+    // order statistics，只有ranked_map可用，都是O(log n)
+    iterator select(size_type k) { return t.select(k); }
+    const_iterator select(size_type k) const { return t.select(k); }
+    size_type rank(const key_type& x) const { return t.rank(x); }
+    difference_type distance(const_iterator first,
+                             const_iterator last) const {
+        return t.distance(first, last);
+    }
+    friend bool operator== <>(const map&, const map&);
+    friend bool operator< <>(const map&, const map&);
 };
 
-template <class Key, class T, class Compare, class Alloc>
-inline bool operator==(const map<Key, T, Compare, Alloc>& x,
-                       const map<Key, T, Compare, Alloc>& y) {
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
+inline bool operator==(const map<Key, T, Compare, Alloc, NodeBase>& x,
+                       const map<Key, T, Compare, Alloc, NodeBase>& y) {
     return x.t == y.t;
 }
 
-template <class Key, class T, class Compare, class Alloc>
-inline bool operator<(const map<Key, T, Compare, Alloc>& x,
-                      const map<Key, T, Compare, Alloc>& y) {
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
+inline bool operator<(const map<Key, T, Compare, Alloc, NodeBase>& x,
+                      const map<Key, T, Compare, Alloc, NodeBase>& y) {
     return x.t < y.t;
 }
 
-
-template <class Key, class T, class Compare, class Alloc>
-inline void swap(map<Key, T, Compare, Alloc>& x,
-                 map<Key, T, Compare, Alloc>& y) {
+template <class Key, class T, class Compare, class Alloc, class NodeBase>
+inline void swap(map<Key, T, Compare, Alloc, NodeBase>& x,
+                 map<Key, T, Compare, Alloc, NodeBase>& y) {
     x.swap(y);
 }
 
-}
+//维护子树大小的map，每个节点多一个size_t
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = alloc>
+using ranked_map = map<Key, T, Compare, Alloc, __rb_tree_rank_node_base>;
+
+}  // namespace TinySTL
 
 #endif
\ No newline at end of file
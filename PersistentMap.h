@@ -0,0 +1,492 @@
+#ifndef PERSISTENTMAP_H__
+#define PERSISTENTMAP_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Iterator.h"
+
+namespace TinySTL {
+
+//节点一旦链入树中就不再修改，只会被多个版本共享，引用计数为0时释放
+template <class Value>
+struct __pmap_node {
+    std::atomic<size_t> refs;
+    __pmap_node* left;
+    __pmap_node* right;
+    int height;  // AVL树的高度，叶子为1
+    Value value;
+};
+
+//节点没有父指针（同一个节点可能挂在不同版本的不同父节点下），
+//迭代器自己记住从根到当前节点的路径
+template <class Value>
+struct __pmap_iterator {
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef const Value* pointer;
+    typedef const Value& reference;
+    typedef ptrdiff_t difference_type;
+    typedef __pmap_iterator<Value> self;
+    typedef __pmap_node<Value>* link_type;
+    // AVL树高不超过1.44log(n)，48层足够放下40亿个元素
+    enum { max_depth = 48 };
+
+    link_type root;
+    int depth;  // 0表示end()
+    link_type path[max_depth];  // path[depth - 1]是当前节点
+
+    __pmap_iterator() : root(0), depth(0) {}
+    explicit __pmap_iterator(link_type r) : root(r), depth(0) {}
+    __pmap_iterator(const self& x) : root(x.root), depth(x.depth) {
+        std::copy(x.path, x.path + x.depth, path);
+    }
+    self& operator=(const self& x) {
+        root = x.root;
+        depth = x.depth;
+        std::copy(x.path, x.path + x.depth, path);
+        return *this;
+    }
+
+    reference operator*() const { return path[depth - 1]->value; }
+    pointer operator->() const { return &(operator*()); }
+
+    void push_leftmost(link_type x) {
+        for (; x; x = x->left) path[depth++] = x;
+    }
+    void push_rightmost(link_type x) {
+        for (; x; x = x->right) path[depth++] = x;
+    }
+    //没有右子树时往上退，直到从某个节点的左子树退回来
+    void increment() {
+        link_type x = path[depth - 1];
+        if (x->right) {
+            push_leftmost(x->right);
+            return;
+        }
+        --depth;
+        while (depth > 0 && path[depth - 1]->right == x) x = path[--depth];
+    }
+    // end()的前一个是最大的元素
+    void decrement() {
+        if (depth == 0) {
+            push_rightmost(root);
+            return;
+        }
+        link_type x = path[depth - 1];
+        if (x->left) {
+            push_rightmost(x->left);
+            return;
+        }
+        --depth;
+        while (depth > 0 && path[depth - 1]->left == x) x = path[--depth];
+    }
+
+    self& operator++() {
+        increment();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        increment();
+        return tmp;
+    }
+    self& operator--() {
+        decrement();
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        decrement();
+        return tmp;
+    }
+    bool operator==(const self& x) const {
+        return depth == x.depth &&
+               (depth == 0 || path[depth - 1] == x.path[depth - 1]);
+    }
+    bool operator!=(const self& x) const { return !(*this == x); }
+};
+
+//持久化的有序map，底层是路径复制的AVL树
+//复制（取快照）只是根节点引用计数加1，是O(1)的；修改时只复制从根到
+//被改节点路径上的O(log n)个节点，其余子树仍与旧版本共享，旧版本不受影响
+//节点不可变、引用计数是原子的，不同线程可以各自持有同一棵树的不同快照，
+//读者遍历快照不用加锁；同一个persistent_map对象本身不能被多个线程同时使用
+//修改使本对象的迭代器失效，其他快照的迭代器不受影响
+//快照可能在读者线程中释放节点，默认用线程安全的malloc_alloc
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = malloc_alloc>
+class persistent_map {
+   public:
+    // typedefs:
+
+    typedef Key key_type;
+    typedef T data_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef Compare key_compare;
+    typedef const value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef const value_type& reference;
+    typedef const value_type& const_reference;
+    typedef __pmap_iterator<value_type> const_iterator;
+    typedef const_iterator iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef const_reverse_iterator reverse_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+   protected:
+    typedef __pmap_node<value_type> node;
+    typedef node* link_type;
+    typedef simple_alloc<node, Alloc> node_allocator;
+
+    link_type root;
+    size_type node_count;
+    Compare comp;
+
+    static int height(link_type x) { return x ? x->height : 0; }
+    static const Key& key(link_type x) { return x->value.first; }
+    static link_type retain(link_type x) {
+        if (x) x->refs.fetch_add(1, std::memory_order_relaxed);
+        return x;
+    }
+    //最后一个引用释放时连同子树一起释放，沿右子树循环以减少递归深度
+    static void release(link_type x) {
+        while (x && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            release(x->left);
+            link_type r = x->right;
+            destroy(&x->value);
+            node_allocator::deallocate(x);
+            x = r;
+        }
+    }
+    //新节点还没有子树，复制v抛出异常时不留下任何东西
+    static link_type create_node(const value_type& v) {
+        link_type x = node_allocator::allocate();
+        try {
+            construct(&x->value, v);
+        }
+        catch (...) {
+            node_allocator::deallocate(x);
+            throw;
+        }
+        construct(&x->refs, size_t(1));
+        return x;
+    }
+    static void drop_node(link_type x) {
+        if (!x) return;
+        destroy(&x->value);
+        node_allocator::deallocate(x);
+    }
+    //挂上子树（接管l和r的引用）并更新高度
+    static link_type link(link_type x, link_type l, link_type r) {
+        x->left = l;
+        x->right = r;
+        x->height = std::max(height(l), height(r)) + 1;
+        return x;
+    }
+
+    static link_type balance(const value_type& v, link_type l, link_type r);
+    link_type insert_node(link_type t, const value_type& v) const;
+    link_type erase_node(link_type t, const Key& k) const;
+    static link_type erase_min(link_type t);
+    int __verify_node(link_type x, size_type& n) const;
+
+   public:
+    // allocation/deallocation
+
+    persistent_map() : root(0), node_count(0), comp(Compare()) {}
+    explicit persistent_map(const Compare& c)
+        : root(0), node_count(0), comp(c) {}
+
+    template <class InputIterator>
+    persistent_map(InputIterator first, InputIterator last)
+        : root(0), node_count(0), comp(Compare()) {
+        insert(first, last);
+    }
+
+    //快照：和x共享整棵树
+    persistent_map(const persistent_map& x)
+        : root(retain(x.root)), node_count(x.node_count), comp(x.comp) {}
+    persistent_map& operator=(const persistent_map& x) {
+        link_type old = root;
+        root = retain(x.root);
+        node_count = x.node_count;
+        comp = x.comp;
+        release(old);
+        return *this;
+    }
+    ~persistent_map() { release(root); }
+
+    // accessors:
+
+    key_compare key_comp() const { return comp; }
+    const_iterator begin() const {
+        const_iterator it(root);
+        it.push_leftmost(root);
+        return it;
+    }
+    const_iterator end() const { return const_iterator(root); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+    bool empty() const { return node_count == 0; }
+    size_type size() const { return node_count; }
+    size_type max_size() const { return size_type(-1); }
+    void swap(persistent_map& x) {
+        std::swap(root, x.root);
+        std::swap(node_count, x.node_count);
+        std::swap(comp, x.comp);
+    }
+
+    // insert/erase
+
+    //复制路径上的节点得到新根，复制元素抛出异常时map不变
+    std::pair<const_iterator, bool> insert(const value_type& v) {
+        const_iterator it = find(v.first);
+        if (it != end()) return std::pair<const_iterator, bool>(it, false);
+        link_type t = insert_node(root, v);
+        release(root);
+        root = t;
+        ++node_count;
+        return std::pair<const_iterator, bool>(find(v.first), true);
+    }
+    //键已存在时复制路径并换成新值，元素不能原地修改
+    std::pair<const_iterator, bool> insert_or_assign(const key_type& k,
+                                                     const T& obj) {
+        bool inserted = find(k) == end();
+        link_type t = insert_node(root, value_type(k, obj));
+        release(root);
+        root = t;
+        node_count += inserted;
+        return std::pair<const_iterator, bool>(find(k), inserted);
+    }
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    size_type erase(const key_type& k) {
+        if (find(k) == end()) return 0;
+        link_type t = erase_node(root, k);
+        release(root);  // k可能就在旧树里，之后不再使用
+        root = t;
+        --node_count;
+        return 1;
+    }
+    void erase(const_iterator position) { erase(position->first); }
+    void clear() {
+        release(root);
+        root = 0;
+        node_count = 0;
+    }
+
+    // map operations:
+
+    const_iterator find(const key_type& k) const {
+        const_iterator it(root);
+        for (link_type x = root; x;) {
+            it.path[it.depth++] = x;
+            if (comp(k, key(x)))
+                x = x->left;
+            else if (comp(key(x), k))
+                x = x->right;
+            else
+                return it;
+        }
+        return end();
+    }
+    size_type count(const key_type& k) const { return find(k) != end(); }
+    //沿途记下路径，最后截到最后一个满足条件的节点
+    const_iterator lower_bound(const key_type& k) const {
+        const_iterator it(root);
+        int keep = 0;
+        for (link_type x = root; x;) {
+            it.path[it.depth++] = x;
+            if (!comp(key(x), k)) {
+                keep = it.depth;
+                x = x->left;
+            } else
+                x = x->right;
+        }
+        it.depth = keep;
+        return it;
+    }
+    const_iterator upper_bound(const key_type& k) const {
+        const_iterator it(root);
+        int keep = 0;
+        for (link_type x = root; x;) {
+            it.path[it.depth++] = x;
+            if (comp(k, key(x))) {
+                keep = it.depth;
+                x = x->left;
+            } else
+                x = x->right;
+        }
+        it.depth = keep;
+        return it;
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& k) const {
+        return std::pair<const_iterator, const_iterator>(lower_bound(k),
+                                                         upper_bound(k));
+    }
+
+   public:
+    // Debugging.
+    bool __pmap_verify() const {
+        size_type n = 0;
+        return __verify_node(root, n) >= 0 && n == node_count;
+    }
+};
+
+template <class Key, class T, class Compare, class Alloc>
+inline bool operator==(const persistent_map<Key, T, Compare, Alloc>& x,
+                       const persistent_map<Key, T, Compare, Alloc>& y) {
+    return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());
+}
+
+template <class Key, class T, class Compare, class Alloc>
+inline bool operator<(const persistent_map<Key, T, Compare, Alloc>& x,
+                      const persistent_map<Key, T, Compare, Alloc>& y) {
+    return std::lexicographical_compare(x.begin(), x.end(), y.begin(),
+                                        y.end());
+}
+
+template <class Key, class T, class Compare, class Alloc>
+inline void swap(persistent_map<Key, T, Compare, Alloc>& x,
+                 persistent_map<Key, T, Compare, Alloc>& y) {
+    x.swap(y);
+}
+
+//以v为根、l和r为子树建新节点，两边高度差为2时旋转
+//l和r可能被其他版本共享，旋转时不改动它们，而是复制它们的值建新节点；
+//所有新节点先建好再挂子树，复制值抛出异常时释放l和r，不会泄漏
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::link_type
+persistent_map<Key, T, Compare, Alloc>::balance(const value_type& v,
+                                                link_type l, link_type r) {
+    int hl = height(l), hr = height(r);
+    link_type x = 0, y = 0, z = 0;
+    try {
+        x = create_node(v);
+        if (hl > hr + 1) {
+            y = create_node(l->value);
+            if (height(l->left) < height(l->right))
+                z = create_node(l->right->value);
+        } else if (hr > hl + 1) {
+            y = create_node(r->value);
+            if (height(r->right) < height(r->left))
+                z = create_node(r->left->value);
+        }
+    }
+    catch (...) {
+        drop_node(x);
+        drop_node(y);
+        release(l);
+        release(r);
+        throw;
+    }
+    if (hl > hr + 1) {
+        link_type ll = l->left, lr = l->right, top;
+        if (!z) {  //右旋
+            link(x, retain(lr), r);
+            top = link(y, retain(ll), x);
+        } else {  //先左旋l再右旋
+            link(y, retain(ll), retain(lr->left));
+            link(x, retain(lr->right), r);
+            top = link(z, y, x);
+        }
+        release(l);
+        return top;
+    }
+    if (hr > hl + 1) {
+        link_type rl = r->left, rr = r->right, top;
+        if (!z) {  //左旋
+            link(x, l, retain(rl));
+            top = link(y, x, retain(rr));
+        } else {  //先右旋r再左旋
+            link(x, l, retain(rl->left));
+            link(y, retain(rl->right), retain(rr));
+            top = link(z, x, y);
+        }
+        release(r);
+        return top;
+    }
+    return link(x, l, r);
+}
+
+//返回插入或替换v之后的新子树，t本身不变
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::link_type
+persistent_map<Key, T, Compare, Alloc>::insert_node(
+    link_type t, const value_type& v) const {
+    if (!t) return balance(v, 0, 0);
+    if (comp(v.first, key(t))) {
+        link_type l = insert_node(t->left, v);
+        return balance(t->value, l, retain(t->right));
+    }
+    if (comp(key(t), v.first)) {
+        link_type r = insert_node(t->right, v);
+        return balance(t->value, retain(t->left), r);
+    }
+    return balance(v, retain(t->left), retain(t->right));
+}
+
+//返回删除k之后的新子树，k必须存在
+//有两个子节点时用右子树的最小值代替被删节点
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::link_type
+persistent_map<Key, T, Compare, Alloc>::erase_node(link_type t,
+                                                   const Key& k) const {
+    if (comp(k, key(t))) {
+        link_type l = erase_node(t->left, k);
+        return balance(t->value, l, retain(t->right));
+    }
+    if (comp(key(t), k)) {
+        link_type r = erase_node(t->right, k);
+        return balance(t->value, retain(t->left), r);
+    }
+    if (!t->left) return retain(t->right);
+    if (!t->right) return retain(t->left);
+    link_type m = t->right;
+    while (m->left) m = m->left;
+    link_type r = erase_min(t->right);
+    return balance(m->value, retain(t->left), r);
+}
+
+template <class Key, class T, class Compare, class Alloc>
+typename persistent_map<Key, T, Compare, Alloc>::link_type
+persistent_map<Key, T, Compare, Alloc>::erase_min(link_type t) {
+    if (!t->left) return retain(t->right);
+    link_type l = erase_min(t->left);
+    return balance(t->value, l, retain(t->right));
+}
+
+//检查有序、高度正确且平衡，返回子树高度，出错返回-1
+template <class Key, class T, class Compare, class Alloc>
+int persistent_map<Key, T, Compare, Alloc>::__verify_node(
+    link_type x, size_type& n) const {
+    if (!x) return 0;
+    if (x->refs.load(std::memory_order_relaxed) == 0) return -1;
+    if (x->left && !comp(key(x->left), key(x))) return -1;
+    if (x->right && !comp(key(x), key(x->right))) return -1;
+    int hl = __verify_node(x->left, n), hr = __verify_node(x->right, n);
+    if (hl < 0 || hr < 0 || hl - hr > 1 || hr - hl > 1) return -1;
+    if (x->height != std::max(hl, hr) + 1) return -1;
+    ++n;
+    return x->height;
+}
+
+}  // namespace TinySTL
+
+#endif
@@ -1,6 +1,380 @@
 #ifndef QUEUE_H__
 #define QUEUE_H__
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Deque.h"
 
+namespace TinySTL {
 
-#endif
\ No newline at end of file
+template <class T, class Sequence = deque<T> >
+class queue;
+
+template <class T, class Sequence>
+bool operator==(const queue<T, Sequence>& x, const queue<T, Sequence>& y);
+template <class T, class Sequence>
+bool operator<(const queue<T, Sequence>& x, const queue<T, Sequence>& y);
+
+//先进先出的配接器，底层容器需提供front、back、push_back、pop_front
+template <class T, class Sequence>
+class queue {
+    friend bool operator== <>(const queue&, const queue&);
+    friend bool operator< <>(const queue&, const queue&);
+
+   public:
+    typedef typename Sequence::value_type value_type;
+    typedef typename Sequence::size_type size_type;
+    typedef typename Sequence::reference reference;
+    typedef typename Sequence::const_reference const_reference;
+
+   protected:
+    Sequence c;
+
+   public:
+    bool empty() const { return c.empty(); }
+    size_type size() const { return c.size(); }
+    reference front() { return c.front(); }
+    const_reference front() const { return c.front(); }
+    reference back() { return c.back(); }
+    const_reference back() const { return c.back(); }
+    void push(const value_type& x) { c.push_back(x); }
+    void pop() { c.pop_front(); }
+};
+
+template <class T, class Sequence>
+bool operator==(const queue<T, Sequence>& x, const queue<T, Sequence>& y) {
+    return x.c == y.c;
+}
+
+template <class T, class Sequence>
+bool operator<(const queue<T, Sequence>& x, const queue<T, Sequence>& y) {
+    return x.c < y.c;
+}
+
+//单生产者单消费者的有界环形队列，无锁
+//head只由消费者写，tail只由生产者写，各占一条cache line避免伪共享
+//双方各自缓存对方的下标，只有看起来满/空时才去读对方的cache line
+//下标单调递增，用mask取槽位，容量向上取整为2的幂
+template <class T, class Alloc = alloc>
+class spsc_queue {
+   public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+
+   protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+    enum { cache_line_size = 64 };
+
+    //生产者独占
+    alignas(cache_line_size) std::atomic<size_type> tail;
+    size_type cached_head;
+    //消费者独占
+    alignas(cache_line_size) std::atomic<size_type> head;
+    size_type cached_tail;
+    //构造后只读
+    alignas(cache_line_size) pointer slots;
+    size_type mask;
+
+    static size_type round_up(size_type n) {
+        size_type r = 1;
+        while (r < n) r <<= 1;
+        return r;
+    }
+
+    //生产者调用，返回可写入的槽位数
+    size_type free_slots(size_type t) {
+        size_type cap = mask + 1;
+        if (t - cached_head == cap)
+            cached_head = head.load(std::memory_order_acquire);
+        return cap - (t - cached_head);
+    }
+    //消费者调用，返回可读出的元素数
+    size_type ready_slots(size_type h) {
+        if (h == cached_tail)
+            cached_tail = tail.load(std::memory_order_acquire);
+        return cached_tail - h;
+    }
+
+   public:
+    explicit spsc_queue(size_type capacity)
+        : tail(0), cached_head(0), head(0), cached_tail(0) {
+        size_type cap = round_up(capacity < 2 ? 2 : capacity);
+        slots = data_allocator::allocate(cap);
+        mask = cap - 1;
+    }
+    ~spsc_queue() {
+        size_type t = tail.load(std::memory_order_relaxed);
+        for (size_type h = head.load(std::memory_order_relaxed); h != t; ++h)
+            destroy(slots + (h & mask));
+        data_allocator::deallocate(slots, mask + 1);
+    }
+
+   private:
+    spsc_queue(const spsc_queue&);
+    spsc_queue& operator=(const spsc_queue&);
+
+   public:
+    size_type capacity() const { return mask + 1; }
+    //另一端可能同时在修改，结果只是近似值
+    size_type size() const {
+        return tail.load(std::memory_order_acquire) -
+               head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+    //队列满时返回false，只能由生产者线程调用
+    bool try_push(const value_type& x) {
+        size_type t = tail.load(std::memory_order_relaxed);
+        if (free_slots(t) == 0) return false;
+        construct(slots + (t & mask), x);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    //队列空时返回false，只能由消费者线程调用
+    bool try_pop(reference x) {
+        size_type h = head.load(std::memory_order_relaxed);
+        if (ready_slots(h) == 0) return false;
+        pointer p = slots + (h & mask);
+        x = *p;
+        destroy(p);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    //批量写入最多n个元素，只发布一次tail，返回实际写入的个数
+    template <class InputIterator>
+    size_type push_n(InputIterator first, size_type n) {
+        size_type t = tail.load(std::memory_order_relaxed);
+        size_type avail = cached_head + mask + 1 - t;
+        if (avail < n) {
+            cached_head = head.load(std::memory_order_acquire);
+            avail = cached_head + mask + 1 - t;
+        }
+        if (n > avail) n = avail;
+        for (size_type i = 0; i < n; ++i, ++first)
+            construct(slots + ((t + i) & mask), *first);
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    //批量读出最多n个元素，只发布一次head，返回实际读出的个数
+    template <class OutputIterator>
+    size_type pop_n(OutputIterator result, size_type n) {
+        size_type h = head.load(std::memory_order_relaxed);
+        size_type avail = cached_tail - h;
+        if (avail < n) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            avail = cached_tail - h;
+        }
+        if (n > avail) n = avail;
+        for (size_type i = 0; i < n; ++i, ++result) {
+            pointer p = slots + ((h + i) & mask);
+            *result = *p;
+            destroy(p);
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+};
+
+//忙等时的退避：先空转若干次，之后让出CPU
+struct __backoff {
+    unsigned count;
+
+    __backoff() : count(0) {}
+    void pause() {
+        if (count < 64) {
+            ++count;
+#if defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#endif
+        } else
+            std::this_thread::yield();
+    }
+};
+
+template <class T>
+struct __mpmc_slot {
+    std::atomic<size_t> seq;  //轮到哪个下标使用该槽位
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return (T*)storage; }
+};
+
+//多生产者多消费者的有界环形队列，每个槽位带一个序号
+//槽位seq == pos时可写入下标pos，写入后置为pos + 1表示可读
+//读出后置为pos + capacity，留给下一轮的写入者
+//try_*失败立即返回，*_for最多等待给定时间，push/pop阻塞直到完成
+//领取下标后槽位必须发布，否则读者永远等在这个下标上：
+//复制先在队列外完成，槽位里只做移动构造和移动赋值，T的移动不能抛出异常
+template <class T, class Alloc = alloc>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible<T>::value &&
+                      std::is_nothrow_move_assignable<T>::value,
+                  "mpmc_queue requires T with nothrow move");
+
+   public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+
+   protected:
+    typedef __mpmc_slot<T> slot;
+    typedef simple_alloc<slot, Alloc> slot_allocator;
+    typedef std::chrono::steady_clock clock;
+    enum { cache_line_size = 64 };
+
+    alignas(cache_line_size) std::atomic<size_type> enqueue_pos;
+    alignas(cache_line_size) std::atomic<size_type> dequeue_pos;
+    alignas(cache_line_size) slot* slots;
+    size_type mask;
+
+    static size_type round_up(size_type n) {
+        size_type r = 1;
+        while (r < n) r <<= 1;
+        return r;
+    }
+
+   public:
+    explicit mpmc_queue(size_type capacity) : enqueue_pos(0), dequeue_pos(0) {
+        size_type cap = round_up(capacity < 2 ? 2 : capacity);
+        slots = slot_allocator::allocate(cap);
+        mask = cap - 1;
+        for (size_type i = 0; i < cap; ++i) construct(&slots[i].seq, i);
+    }
+    //析构时不能有其他线程在使用队列
+    ~mpmc_queue() {
+        size_type t = enqueue_pos.load(std::memory_order_relaxed);
+        for (size_type h = dequeue_pos.load(std::memory_order_relaxed); h != t;
+             ++h)
+            destroy(slots[h & mask].value());
+        slot_allocator::deallocate(slots, mask + 1);
+    }
+
+   private:
+    mpmc_queue(const mpmc_queue&);
+    mpmc_queue& operator=(const mpmc_queue&);
+
+   public:
+    size_type capacity() const { return mask + 1; }
+    //其他线程可能同时在修改，结果只是近似值
+    size_type size() const {
+        size_type t = enqueue_pos.load(std::memory_order_acquire);
+        size_type h = dequeue_pos.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    //队列满时返回false，x不变
+    bool try_push(const value_type& x) { return try_push(value_type(x)); }
+    bool try_push(value_type&& x) {
+        size_type pos = enqueue_pos.load(std::memory_order_relaxed);
+        slot* s;
+        for (;;) {
+            s = &slots[pos & mask];
+            size_type seq = s->seq.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0)
+                return false;  //上一轮的元素还没被取走
+            else
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+        construct(s->value(), std::move(x));
+        s->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //队列空时返回false
+    bool try_pop(reference x) {
+        size_type pos = dequeue_pos.load(std::memory_order_relaxed);
+        slot* s;
+        for (;;) {
+            s = &slots[pos & mask];
+            size_type seq = s->seq.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0)
+                return false;  //该下标还没有写入者
+            else
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+        x = std::move(*s->value());
+        destroy(s->value());
+        s->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    //先领取下标再等待槽位轮到自己，不会因CAS竞争而重试
+    void push(const value_type& x) { push(value_type(x)); }
+    void push(value_type&& x) {
+        size_type pos = enqueue_pos.fetch_add(1, std::memory_order_relaxed);
+        slot* s = &slots[pos & mask];
+        __backoff b;
+        while (s->seq.load(std::memory_order_acquire) != pos) b.pause();
+        construct(s->value(), std::move(x));
+        s->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    void pop(reference x) {
+        size_type pos = dequeue_pos.fetch_add(1, std::memory_order_relaxed);
+        slot* s = &slots[pos & mask];
+        __backoff b;
+        while (s->seq.load(std::memory_order_acquire) != pos + 1) b.pause();
+        x = std::move(*s->value());
+        destroy(s->value());
+        s->seq.store(pos + mask + 1, std::memory_order_release);
+    }
+
+    //超时返回false
+    template <class Rep, class Period>
+    bool try_push_for(const value_type& x,
+                      const std::chrono::duration<Rep, Period>& timeout) {
+        return try_push_for(value_type(x), timeout);
+    }
+    template <class Rep, class Period>
+    bool try_push_for(value_type&& x,
+                      const std::chrono::duration<Rep, Period>& timeout) {
+        clock::time_point deadline = clock::now() + timeout;
+        __backoff b;
+        while (!try_push(std::move(x))) {
+            if (clock::now() >= deadline) return false;
+            b.pause();
+        }
+        return true;
+    }
+
+    template <class Rep, class Period>
+    bool try_pop_for(reference x,
+                     const std::chrono::duration<Rep, Period>& timeout) {
+        clock::time_point deadline = clock::now() + timeout;
+        __backoff b;
+        while (!try_pop(x)) {
+            if (clock::now() >= deadline) return false;
+            b.pause();
+        }
+        return true;
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
@@ -2,8 +2,12 @@
 #define RB_TREE_H__
 
 #include <algorithm>
+#include <iterator>
+#include <utility>
 #include "Alloc.h"
 #include "Construct.h"
+#include "Function.h"
+#include "Iterator.h"
 
 namespace TinySTL {
 
@@ -29,11 +33,53 @@ struct __rb_tree_node_base {
         while (x->right != 0) x = x->right;
         return x;
     }
+
+    //维护附加信息的钩子，旋转和插入删除时调用，普通节点什么也不做
+    static void update(base_ptr) {}                  //由子节点重算x
+    static void copy_augment(base_ptr, base_ptr) {}  //复制树时照搬
+    static void inserted(base_ptr, base_ptr) {}      //新节点挂上之后
+    static void erasing(base_ptr, base_ptr) {}       //摘下节点之前
+    static bool verify(base_ptr) { return true; }
 };
 
-template <class Value>
-struct __rb_tree_node : public __rb_tree_node_base {
-    typedef __rb_tree_node<Value>* link_type;
+//带子树大小的节点，rb_tree用它做NodeBase时支持按序号访问：
+// select(k)、rank(key)和O(log n)的distance，每个节点多一个size_t
+struct __rb_tree_rank_node_base : public __rb_tree_node_base {
+    size_t size;  //以该节点为根的子树中的节点数
+
+    static size_t size_of(base_ptr x) {
+        return x ? ((__rb_tree_rank_node_base*)x)->size : 0;
+    }
+    static void update(base_ptr x) {
+        ((__rb_tree_rank_node_base*)x)->size =
+            1 + size_of(x->left) + size_of(x->right);
+    }
+    static void copy_augment(base_ptr x, base_ptr from) {
+        ((__rb_tree_rank_node_base*)x)->size = size_of(from);
+    }
+    //新叶子x到root路径上的节点各加1
+    static void inserted(base_ptr x, base_ptr root) {
+        ((__rb_tree_rank_node_base*)x)->size = 1;
+        while (x != root) {
+            x = x->parent;
+            ++((__rb_tree_rank_node_base*)x)->size;
+        }
+    }
+    // x下面要摘掉一个节点，x到root路径上的节点各减1
+    static void erasing(base_ptr x, base_ptr root) {
+        for (;; x = x->parent) {
+            --((__rb_tree_rank_node_base*)x)->size;
+            if (x == root) break;
+        }
+    }
+    static bool verify(base_ptr x) {
+        return size_of(x) == 1 + size_of(x->left) + size_of(x->right);
+    }
+};
+
+template <class Value, class NodeBase = __rb_tree_node_base>
+struct __rb_tree_node : public NodeBase {
+    typedef __rb_tree_node<Value, NodeBase>* link_type;
     Value value_field;
 };
 
@@ -75,16 +121,17 @@ struct __rb_tree_base_iterator {
     }
 };
 
-template <class Value, class Ref, class Ptr>
+template <class Value, class Ref, class Ptr,
+          class NodeBase = __rb_tree_node_base>
 struct __rb_tree_iterator : public __rb_tree_base_iterator {
     typedef Value value_type;
     typedef Ref reference;
     typedef Ptr pointer;
-    typedef __rb_tree_iterator<Value, Value&, Value*> iterator;
-    typedef __rb_tree_iterator<Value, const Value&, const Value*>
+    typedef __rb_tree_iterator<Value, Value&, Value*, NodeBase> iterator;
+    typedef __rb_tree_iterator<Value, const Value&, const Value*, NodeBase>
         const_iterator;
-    typedef __rb_tree_iterator<Value, Ref, Ptr> self;
-    typedef __rb_tree_node<Value>* link_type;
+    typedef __rb_tree_iterator<Value, Ref, Ptr, NodeBase> self;
+    typedef __rb_tree_node<Value, NodeBase>* link_type;
 
     __rb_tree_iterator() {}
     __rb_tree_iterator(link_type x) { node = x; }
@@ -126,6 +173,7 @@ inline bool operator!=(const __rb_tree_base_iterator& x,
     return x.node != y.node;
 }
 
+template <class NodeBase>
 inline void __rb_tree_rotate_left(__rb_tree_node_base* x,
                                   __rb_tree_node_base*& root) {
     __rb_tree_node_base* y = x->right;
@@ -141,8 +189,11 @@ inline void __rb_tree_rotate_left(__rb_tree_node_base* x,
         x->parent->right = y;
     y->left = x;
     x->parent = y;
+    NodeBase::update(x);
+    NodeBase::update(y);
 }
 
+template <class NodeBase>
 inline void __rb_tree_rotate_right(__rb_tree_node_base* x,
                                    __rb_tree_node_base*& root) {
     __rb_tree_node_base* y = x->left;
@@ -158,9 +209,13 @@ inline void __rb_tree_rotate_right(__rb_tree_node_base* x,
         x->parent->left = y;
     y->right = x;
     x->parent = y;
+    NodeBase::update(x);
+    NodeBase::update(y);
 }
 
-inline void __rb_tree_rebalance(__rb_tree_node_base* x,
+//把红节点x挂上后向上调整，返回树的黑高度是否增加了1
+template <class NodeBase>
+inline bool __rb_tree_rebalance(__rb_tree_node_base* x,
                                 __rb_tree_node_base*& root) {
     x->color = __rb_tree_red;
     while (x != root && x->parent->color == __rb_tree_red) {
@@ -177,11 +232,11 @@ inline void __rb_tree_rebalance(__rb_tree_node_base* x,
             } else {                          //如果伯父节点是黑
                 if (x == x->parent->right) {  //如果是父节点的右子节点 先左旋
                     x = x->parent;
-                    __rb_tree_rotate_left(x, root);
+                    __rb_tree_rotate_left<NodeBase>(x, root);
                 }
                 x->parent->color = __rb_tree_black;
                 x->parent->parent->color = __rb_tree_red;
-                __rb_tree_rotate_right(x->parent->parent, root);
+                __rb_tree_rotate_right<NodeBase>(x->parent->parent, root);
             }
         } else {  //如果父节点是祖父节点的右子节点  需要左旋
             __rb_tree_node_base* y = x->parent->parent->left;
@@ -193,17 +248,21 @@ inline void __rb_tree_rebalance(__rb_tree_node_base* x,
             } else {
                 if (x == x->parent->left) {
                     x = x->parent;
-                    __rb_tree_rotate_right(x, root);
+                    __rb_tree_rotate_right<NodeBase>(x, root);
                 }
                 x->parent->color = __rb_tree_black;
                 x->parent->parent->color = __rb_tree_red;
-                __rb_tree_rotate_left(x->parent->parent, root);
+                __rb_tree_rotate_left<NodeBase>(x->parent->parent, root);
             }
         }
     }
+    //只有向上变色一直传到根时根才是红的，涂黑后每条路径多一个黑节点
+    bool grew = root->color == __rb_tree_red;
     root->color = __rb_tree_black;
+    return grew;
 }
 
+template <class NodeBase>
 inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
     __rb_tree_node_base* z, __rb_tree_node_base*& root,
     __rb_tree_node_base*& leftmost, __rb_tree_node_base*& rightmost) {
@@ -219,6 +278,10 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
         while (y->left != 0) y = y->left;
         x = y->right;
     }
+    if (y != z)  // y从原位置摘下，z的位置由y接替
+        NodeBase::erasing(y->parent, root);
+    else if (z != root)
+        NodeBase::erasing(z->parent, root);
     if (y != z) {  // relink y in place of z.  y is z's successor
         z->left->parent = y;
         y->left = z->left;
@@ -237,6 +300,7 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
         else
             z->parent->right = y;
         y->parent = z->parent;
+        NodeBase::update(y);
         std::swap(y->color, z->color);
         y = z;
         // y now points to node to be actually deleted
@@ -269,7 +333,7 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
                 if (w->color == __rb_tree_red) {
                     w->color = __rb_tree_black;
                     x_parent->color = __rb_tree_red;
-                    __rb_tree_rotate_left(x_parent, root);
+                    __rb_tree_rotate_left<NodeBase>(x_parent, root);
                     w = x_parent->right;
                 }
                 if ((w->left == 0 || w->left->color == __rb_tree_black) &&
@@ -281,13 +345,13 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
                     if (w->right == 0 || w->right->color == __rb_tree_black) {
                         if (w->left) w->left->color = __rb_tree_black;
                         w->color = __rb_tree_red;
-                        __rb_tree_rotate_right(w, root);
+                        __rb_tree_rotate_right<NodeBase>(w, root);
                         w = x_parent->right;
                     }
                     w->color = x_parent->color;
                     x_parent->color = __rb_tree_black;
                     if (w->right) w->right->color = __rb_tree_black;
-                    __rb_tree_rotate_left(x_parent, root);
+                    __rb_tree_rotate_left<NodeBase>(x_parent, root);
                     break;
                 }
             } else {  // same as above, with right <-> left.
@@ -295,7 +359,7 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
                 if (w->color == __rb_tree_red) {
                     w->color = __rb_tree_black;
                     x_parent->color = __rb_tree_red;
-                    __rb_tree_rotate_right(x_parent, root);
+                    __rb_tree_rotate_right<NodeBase>(x_parent, root);
                     w = x_parent->left;
                 }
                 if ((w->right == 0 || w->right->color == __rb_tree_black) &&
@@ -307,13 +371,13 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
                     if (w->left == 0 || w->left->color == __rb_tree_black) {
                         if (w->right) w->right->color = __rb_tree_black;
                         w->color = __rb_tree_red;
-                        __rb_tree_rotate_left(w, root);
+                        __rb_tree_rotate_left<NodeBase>(w, root);
                         w = x_parent->left;
                     }
                     w->color = x_parent->color;
                     x_parent->color = __rb_tree_black;
                     if (w->left) w->left->color = __rb_tree_black;
-                    __rb_tree_rotate_right(x_parent, root);
+                    __rb_tree_rotate_right<NodeBase>(x_parent, root);
                     break;
                 }
             }
@@ -322,13 +386,205 @@ inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(
     return y;
 }
 
+//以x为根的子树的黑高度，即x到空指针的路径上的黑节点数
+inline int __rb_tree_black_height(__rb_tree_node_base* x) {
+    int h = 0;
+    for (; x != 0; x = x->left)
+        if (x->color == __rb_tree_black) ++h;
+    return h;
+}
+
+//把子树l、节点k、子树r连成一棵树并返回新的根，l中的键都不大于k，
+// r中的都不小于k；hl、hr是两棵子树的黑高度，h返回新树的黑高度。
+//沿较高一棵的边往下找到和较矮一棵黑高度相同的黑节点c，
+//用红节点k顶替c，c和较矮的一棵作k的子树，再像插入一样向上调整，
+//复杂度O(|hl - hr| + 1)。子树根的parent不必有效
+template <class NodeBase>
+__rb_tree_node_base* __rb_tree_join(__rb_tree_node_base* l, int hl,
+                                    __rb_tree_node_base* k,
+                                    __rb_tree_node_base* r, int hr, int& h) {
+    //子树的根是红的时涂黑，黑高度加1，仍然是红黑树
+    if (l && l->color == __rb_tree_red) l->color = __rb_tree_black, ++hl;
+    if (r && r->color == __rb_tree_red) r->color = __rb_tree_black, ++hr;
+    if (hl == hr) {
+        k->color = __rb_tree_black;
+        k->parent = 0;
+        k->left = l;
+        k->right = r;
+        if (l) l->parent = k;
+        if (r) r->parent = k;
+        NodeBase::update(k);
+        h = hl + 1;
+        return k;
+    }
+    __rb_tree_node_base* root;
+    if (hl > hr) {  //沿l的右边往下
+        root = l;
+        root->parent = 0;
+        __rb_tree_node_base* p = 0;
+        __rb_tree_node_base* c = l;
+        for (int hc = hl; c != 0 && (c->color == __rb_tree_red || hc != hr);
+             p = c, c = c->right)
+            if (c->color == __rb_tree_black) --hc;
+        //根的黑高度大于hr，c不会是根，p不为空
+        p->right = k;
+        k->left = c;
+        k->right = r;
+        if (c) c->parent = k;
+        if (r) r->parent = k;
+        k->parent = p;
+        h = hl;
+    } else {  //沿r的左边往下
+        root = r;
+        root->parent = 0;
+        __rb_tree_node_base* p = 0;
+        __rb_tree_node_base* c = r;
+        for (int hc = hr; c != 0 && (c->color == __rb_tree_red || hc != hl);
+             p = c, c = c->left)
+            if (c->color == __rb_tree_black) --hc;
+        p->left = k;
+        k->right = c;
+        k->left = l;
+        if (c) c->parent = k;
+        if (l) l->parent = k;
+        k->parent = p;
+        h = hr;
+    }
+    for (__rb_tree_node_base* x = k; x != 0; x = x->parent) NodeBase::update(x);
+    h += __rb_tree_rebalance<NodeBase>(k, root);
+    return root;
+}
+
+//在pos处把以root为根的树分成pos之前的l和从pos开始的r两棵，hl、hr是黑高度
+//从pos往上走到根，每层把父节点和另一侧的子树连接到对应的一边，
+//各次连接的高度差加起来是O(log n)
+template <class NodeBase>
+void __rb_tree_split(__rb_tree_node_base* pos, __rb_tree_node_base* root,
+                     __rb_tree_node_base*& l, int& hl,
+                     __rb_tree_node_base*& r, int& hr) {
+    typedef __rb_tree_node_base* base_ptr;
+    int h = __rb_tree_black_height(pos);  //当前节点y的黑高度
+    //连接会改动节点的链接，父节点和所在的一侧都要先取出来
+    base_ptr p = pos == root ? 0 : pos->parent;
+    bool from_left = p && p->left == pos;
+    int hc = h - (pos->color == __rb_tree_black);
+    l = pos->left;
+    hl = hc;
+    r = __rb_tree_join<NodeBase>(0, 0, pos, pos->right, hc, hr);
+    while (p != 0) {
+        base_ptr next = p == root ? 0 : p->parent;
+        bool next_left = next && next->left == p;
+        int hp = h + (p->color == __rb_tree_black);
+        //兄弟子树的黑高度和y相同
+        if (from_left)
+            r = __rb_tree_join<NodeBase>(r, hr, p, p->right, h, hr);
+        else
+            l = __rb_tree_join<NodeBase>(p->left, h, p, l, hl, hl);
+        p = next;
+        from_left = next_left;
+        h = hp;
+    }
+}
+
+//从黑高度为h的子树x中摘下最大的节点k，返回剩下的树，黑高度放在h_rest
+template <class NodeBase>
+__rb_tree_node_base* __rb_tree_split_last(__rb_tree_node_base* x, int h,
+                                          __rb_tree_node_base*& k,
+                                          int& h_rest) {
+    int hc = h - (x->color == __rb_tree_black);
+    if (x->right == 0) {
+        k = x;
+        h_rest = hc;
+        return x->left;
+    }
+    __rb_tree_node_base* l = x->left;
+    __rb_tree_node_base* r =
+        __rb_tree_split_last<NodeBase>(x->right, hc, k, h_rest);
+    return __rb_tree_join<NodeBase>(l, hc, x, r, h_rest, h_rest);
+}
+
+//没有中间节点的连接：从l中摘下最大的节点当作中间节点
+template <class NodeBase>
+__rb_tree_node_base* __rb_tree_join2(__rb_tree_node_base* l, int hl,
+                                     __rb_tree_node_base* r, int hr,
+                                     int& h) {
+    if (l == 0) {
+        h = hr;
+        return r;
+    }
+    if (r == 0) {
+        h = hl;
+        return l;
+    }
+    __rb_tree_node_base* k;
+    l = __rb_tree_split_last<NodeBase>(l, hl, k, hl);
+    return __rb_tree_join<NodeBase>(l, hl, k, r, hr, h);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare,
+          class Alloc, class NodeBase>
+class rb_tree;
+
+//用extract从树上摘下的节点，持有节点和其中的值，只能移动不能复制
+//可以再插入节点类型和配置器都相同的树，不重新配置也不复制值；
+//没有插回去时析构函数负责释放
+template <class Value, class NodeBase, class Alloc>
+class __rb_tree_node_handle {
+    template <class, class, class, class, class, class>
+    friend class rb_tree;
+    typedef __rb_tree_node<Value, NodeBase>* link_type;
+    typedef simple_alloc<__rb_tree_node<Value, NodeBase>, Alloc>
+        node_allocator;
+
+    link_type node;
+
+    explicit __rb_tree_node_handle(link_type p) : node(p) {}
+    link_type release() {
+        link_type p = node;
+        node = 0;
+        return p;
+    }
+    void reset() {
+        if (node) {
+            destroy(&node->value_field);
+            node_allocator::deallocate(node);
+            node = 0;
+        }
+    }
+    __rb_tree_node_handle(const __rb_tree_node_handle&);
+    __rb_tree_node_handle& operator=(const __rb_tree_node_handle&);
+
+   public:
+    typedef Value value_type;
+
+    __rb_tree_node_handle() : node(0) {}
+    __rb_tree_node_handle(__rb_tree_node_handle&& x) : node(x.release()) {}
+    __rb_tree_node_handle& operator=(__rb_tree_node_handle&& x) {
+        if (this != &x) {
+            reset();
+            node = x.release();
+        }
+        return *this;
+    }
+    ~__rb_tree_node_handle() { reset(); }
+
+    bool empty() const { return node == 0; }
+    explicit operator bool() const { return node != 0; }
+    value_type& value() const { return node->value_field; }
+    void swap(__rb_tree_node_handle& x) { std::swap(node, x.node); }
+};
+
+// NodeBase为__rb_tree_rank_node_base时维护子树大小，提供select/rank/distance
 template <class Key, class Value, class KeyOfValue, class Compare,
-          class Alloc = alloc>
+          class Alloc = alloc, class NodeBase = __rb_tree_node_base>
 class rb_tree {
+    template <class, class, class, class, class, class>
+    friend class rb_tree;
+
    protected:
     typedef void* void_pointer;
     typedef __rb_tree_node_base* base_ptr;
-    typedef __rb_tree_node<Value> rb_tree_node;
+    typedef __rb_tree_node<Value, NodeBase> rb_tree_node;
     typedef simple_alloc<rb_tree_node, Alloc> rb_tree_node_allocator;
     typedef __rb_tree_color_type color_type;
 
@@ -347,15 +603,24 @@ class rb_tree {
     link_type get_node() { return rb_tree_node_allocator::allocate(); }
     void put_node(link_type p) { rb_tree_node_allocator::deallocate(p); }
 
-    link_type create_node(const value_type& x) {
+    //用args在节点里原地构造值，构造抛出异常时归还节点
+    template <class... Args>
+    link_type create_node(Args&&... args) {
         link_type tmp = get_node();
-        construct(&tmp->value_field, x);
+        try {
+            construct(&tmp->value_field, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            put_node(tmp);
+            throw;
+        }
         return tmp;
     }
 
     link_type clone_node(link_type x) {
         link_type tmp = create_node(x->value_field);
         tmp->color = x->color;
+        NodeBase::copy_augment(tmp, x);
         tmp->left = 0;
         tmp->right = 0;
         return tmp;
@@ -368,30 +633,24 @@ class rb_tree {
 
    protected:
     size_type node_count;  // keeps track of size of tree
-    link_type header;
+    NodeBase header_node;  // embedded: empty trees allocate nothing
     Compare key_compare;
 
-    link_type& root() const { return (link_type&)header->parent; }
-    link_type& leftmost() const { return (link_type&)header->left; }
-    link_type& rightmost() const { return (link_type&)header->right; }
+    // only ever compared or handed out; links are read through header_node
+    link_type header() const { return (link_type)&header_node; }
 
-    static link_type& left(link_type x) { return (link_type&)(x->left); }
-    static link_type& right(link_type x) { return (link_type&)(x->right); }
-    static link_type& parent(link_type x) { return (link_type&)(x->parent); }
-    static reference value(link_type x) { return x->value_field; }
-    static const Key& key(link_type x) { return KeyOfValue()(value(x)); }
-    static color_type& color(link_type x) { return (color_type&)(x->color); }
+    //链接字段都是base_ptr，读出后转换成link_type；修改时直接写字段，
+    //不把base_ptr当作link_type&来写，免得-O2下按类型的别名分析出错
+    link_type root() const { return (link_type)header_node.parent; }
+    link_type leftmost() const { return (link_type)header_node.left; }
+    link_type rightmost() const { return (link_type)header_node.right; }
 
-    static link_type& left(base_ptr x) { return (link_type&)(x->left); }
-    static link_type& right(base_ptr x) { return (link_type&)(x->right); }
-    static link_type& parent(base_ptr x) { return (link_type&)(x->parent); }
+    static link_type left(base_ptr x) { return (link_type)x->left; }
+    static link_type right(base_ptr x) { return (link_type)x->right; }
+    static link_type parent(base_ptr x) { return (link_type)x->parent; }
     static reference value(base_ptr x) { return ((link_type)x)->value_field; }
-    static const Key& key(base_ptr x) {
-        return KeyOfValue()(value(link_type(x)));
-    }
-    static color_type& color(base_ptr x) {
-        return (color_type&)(link_type(x)->color);
-    }
+    static const Key& key(base_ptr x) { return KeyOfValue()(value(x)); }
+    static color_type& color(base_ptr x) { return x->color; }
 
     static link_type minimum(link_type x) {
         return (link_type)__rb_tree_node_base::minimum(x);
@@ -401,24 +660,107 @@ class rb_tree {
     }
 
    public:
-    typedef __rb_tree_iterator<value_type, reference, pointer> iterator;
-    typedef __rb_tree_iterator<value_type, const_reference, const_pointer>
+    typedef __rb_tree_iterator<value_type, reference, pointer, NodeBase>
+        iterator;
+    typedef __rb_tree_iterator<value_type, const_reference, const_pointer,
+                               NodeBase>
         const_iterator;
 
-    typedef reverse_iterator<const_iterator> const_reverse_iterator;
-    typedef reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
+    typedef __rb_tree_node_handle<value_type, NodeBase, Alloc> node_type;
 
    private:
-    iterator __insert(base_ptr x, base_ptr y, const value_type& v);
+    iterator __insert(base_ptr x, base_ptr y, const value_type& v) {
+        return __link(x, y, create_node(v));
+    }
+    //把已经构造好的节点z挂到y下面并调整平衡
+    iterator __link(base_ptr x, base_ptr y, link_type z);
+    //新键的插入位置(x, y)；键唯一且已存在时返回(已有节点, 0)
+    std::pair<base_ptr, base_ptr> __insert_unique_pos(const key_type& k);
+    std::pair<base_ptr, base_ptr> __insert_equal_pos(const key_type& k);
+    //先看k是否正好落在position之前，是就不用从根查找
+    std::pair<base_ptr, base_ptr> __insert_hint_unique_pos(iterator position,
+                                                           const key_type& k);
+    //把节点从树上摘下但不释放
+    link_type __unlink(base_ptr z) {
+        --node_count;
+        return (link_type)__rb_tree_rebalance_for_erase<NodeBase>(
+            z, header_node.parent, header_node.left, header_node.right);
+    }
     link_type __copy(link_type x, link_type p);
     void __erase(link_type x);
+
+    //以r为根重新设置header，树中有n个元素
+    void __reset_root(base_ptr r, size_type n) {
+        node_count = n;
+        if (r == 0) {
+            init();
+            return;
+        }
+        r->parent = header();
+        r->color = __rb_tree_black;
+        header_node.parent = r;
+        header_node.left = minimum(root());
+        header_node.right = maximum(root());
+    }
+    // [position, end())中的元素个数：带子树大小时O(log n)，
+    //否则从position同时往两头数，代价是较短一边的长度
+    size_type __count_to_end(base_ptr position,
+                             __rb_tree_rank_node_base*) const {
+        return node_count - index_of(const_iterator((link_type)position));
+    }
+    size_type __count_to_end(base_ptr position, __rb_tree_node_base*) const;
+    //集合运算的递归部分，见set_union等；t是本树的子树，u是x的子树，
+    // h是各自的黑高度，n累计键相同的节点数
+    void __split_key(base_ptr x, int h, const key_type& k, base_ptr& l,
+                     int& hl, base_ptr& m, base_ptr& r, int& hr);
+    base_ptr __union(base_ptr t, int ht, base_ptr u, int hu, int& h,
+                     size_type& n);
+    base_ptr __intersection(base_ptr t, int ht, base_ptr u, int hu, int& h,
+                            size_type& n);
+    base_ptr __difference(base_ptr t, int ht, base_ptr u, int hu, int& h,
+                          size_type& n);
+
+    template <class InputIterator>
+    void __insert_range(InputIterator first, InputIterator last, bool unique,
+                        input_iterator_tag);
+    template <class ForwardIterator>
+    void __insert_range(ForwardIterator first, ForwardIterator last,
+                        bool unique, forward_iterator_tag);
+    //标准库容器的迭代器带的是std的标签
+    template <class InputIterator>
+    void __insert_range(InputIterator first, InputIterator last, bool unique,
+                        std::input_iterator_tag) {
+        __insert_range(first, last, unique, input_iterator_tag());
+    }
+    template <class ForwardIterator>
+    void __insert_range(ForwardIterator first, ForwardIterator last,
+                        bool unique, std::forward_iterator_tag) {
+        __insert_range(first, last, unique, forward_iterator_tag());
+    }
+    template <class ForwardIterator>
+    bool __sorted_count(ForwardIterator first, ForwardIterator last,
+                        bool unique, size_type& n) const;
+    template <class ForwardIterator>
+    link_type __build(ForwardIterator& first, ForwardIterator last,
+                      size_type n, size_type depth, size_type red_depth,
+                      bool unique);
     void init() {
-        header = get_node();
-        color(header) = __rb_tree_red;  // used to distinguish header from
-                                        // root, in iterator.operator++
-        root() = 0;
-        leftmost() = header;
-        rightmost() = header;
+        header_node.color = __rb_tree_red;  // used to distinguish header from
+                                            // root, in iterator.operator++
+        header_node.parent = 0;
+        header_node.left = header();
+        header_node.right = header();
+    }
+
+    void reset_header() {
+        if (root() == 0) {
+            header_node.left = header();
+            header_node.right = header();
+        } else
+            root()->parent = header();
     }
 
    public:
@@ -428,36 +770,27 @@ class rb_tree {
         init();
     }
 
-    rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x)
+    rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& x)
         : node_count(0), key_compare(x.key_compare) {
-        header = get_node();
-        color(header) = __rb_tree_red;
-        if (x.root() == 0) {
-            root() = 0;
-            leftmost() = header;
-            rightmost() = header;
-        } else {
-            __STL_TRY { root() = __copy(x.root(), header); }
-            __STL_UNWIND(put_node(header));
-            leftmost() = minimum(root());
-            rightmost() = maximum(root());
+        init();
+        if (x.root() != 0) {
+            header_node.parent = __copy(x.root(), header());
+            header_node.left = minimum(root());
+            header_node.right = maximum(root());
         }
         node_count = x.node_count;
     }
-    ~rb_tree() {
-        clear();
-        put_node(header);
-    }
-    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(
-        const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
+    ~rb_tree() { clear(); }
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& operator=(
+        const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& x);
 
    public:
     // accessors:
     Compare key_comp() const { return key_compare; }
     iterator begin() { return leftmost(); }
     const_iterator begin() const { return leftmost(); }
-    iterator end() { return header; }
-    const_iterator end() const { return header; }
+    iterator end() { return header(); }
+    const_iterator end() const { return header(); }
     reverse_iterator rbegin() { return reverse_iterator(end()); }
     const_reverse_iterator rbegin() const {
         return const_reverse_iterator(end());
@@ -470,10 +803,16 @@ class rb_tree {
     size_type size() const { return node_count; }
     size_type max_size() const { return size_type(-1); }
 
-    void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) {
-        __STD::swap(header, t.header);
-        __STD::swap(node_count, t.node_count);
-        __STD::swap(key_compare, t.key_compare);
+    void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& t) {
+        // header is embedded: swap its links, then repoint root and the
+        // empty-tree self links at the header that now owns them.
+        std::swap(header_node.parent, t.header_node.parent);
+        std::swap(header_node.left, t.header_node.left);
+        std::swap(header_node.right, t.header_node.right);
+        std::swap(node_count, t.node_count);
+        std::swap(key_compare, t.key_compare);
+        reset_header();
+        t.reset_header();
     }
 
    public:
@@ -484,10 +823,104 @@ class rb_tree {
     iterator insert_unique(iterator position, const value_type& x);
     iterator insert_equal(iterator position, const value_type& x);
 
+    // emplace：值直接在新节点里构造，不先构造临时的value_type再复制
+    //键唯一时要先构造出值才知道键，键已存在就销毁这个节点
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique(Args&&... args) {
+        link_type z = create_node(std::forward<Args>(args)...);
+        std::pair<base_ptr, base_ptr> pos = __insert_unique_pos(key(z));
+        if (pos.second)
+            return std::pair<iterator, bool>(__link(pos.first, pos.second, z),
+                                             true);
+        destroy_node(z);
+        return std::pair<iterator, bool>(iterator((link_type)pos.first),
+                                         false);
+    }
+    template <class... Args>
+    iterator emplace_equal(Args&&... args) {
+        link_type z = create_node(std::forward<Args>(args)...);
+        std::pair<base_ptr, base_ptr> pos = __insert_equal_pos(key(z));
+        return __link(pos.first, pos.second, z);
+    }
+    template <class... Args>
+    iterator emplace_hint_unique(iterator position, Args&&... args) {
+        link_type z = create_node(std::forward<Args>(args)...);
+        std::pair<base_ptr, base_ptr> pos =
+            __insert_hint_unique_pos(position, key(z));
+        if (pos.second) return __link(pos.first, pos.second, z);
+        destroy_node(z);
+        return iterator((link_type)pos.first);
+    }
+    //已知键时先查找，键不存在才配置节点并用args构造值，给map::try_emplace用
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace_unique(const key_type& k,
+                                                 Args&&... args) {
+        std::pair<base_ptr, base_ptr> pos = __insert_unique_pos(k);
+        if (!pos.second)
+            return std::pair<iterator, bool>(iterator((link_type)pos.first),
+                                             false);
+        link_type z = create_node(std::forward<Args>(args)...);
+        return std::pair<iterator, bool>(__link(pos.first, pos.second, z),
+                                         true);
+    }
+    template <class... Args>
+    iterator try_emplace_hint_unique(iterator position, const key_type& k,
+                                     Args&&... args) {
+        std::pair<base_ptr, base_ptr> pos =
+            __insert_hint_unique_pos(position, k);
+        if (!pos.second) return iterator((link_type)pos.first);
+        return __link(pos.first, pos.second,
+                      create_node(std::forward<Args>(args)...));
+    }
+
+    //空树插入已排序的区间时O(n)直接建成平衡树，否则逐个插入
     template <class InputIterator>
-    void insert_unique(InputIterator first, InputIterator last);
+    void insert_unique(InputIterator first, InputIterator last) {
+        __insert_range(first, last, true, iterator_category(first));
+    }
     template <class InputIterator>
-    void insert_equal(InputIterator first, InputIterator last);
+    void insert_equal(InputIterator first, InputIterator last) {
+        __insert_range(first, last, false, iterator_category(first));
+    }
+
+    //节点句柄：摘下和插回节点都不配置内存，也不复制值
+    node_type extract(iterator position) {
+        return node_type(__unlink(position.node));
+    }
+    node_type extract(const key_type& x) {
+        iterator i = find(x);
+        return i == end() ? node_type() : extract(i);
+    }
+    //键已存在时不插入，节点留在nh中
+    std::pair<iterator, bool> insert_unique(node_type&& nh);
+    iterator insert_equal(node_type&& nh);
+    //把src中的节点移过来，键唯一时已有的键留在src中；两棵树可以用不同的比较器
+    template <class Compare2>
+    void merge_unique(
+        rb_tree<Key, Value, KeyOfValue, Compare2, Alloc, NodeBase>& src);
+    template <class Compare2>
+    void merge_equal(
+        rb_tree<Key, Value, KeyOfValue, Compare2, Alloc, NodeBase>& src);
+
+    //分裂与连接，只改动O(log n)个节点的链接，不配置内存也不复制元素
+    // [position, end())移到right中，right原有的元素被清除
+    void split(iterator position, rb_tree& right);
+    //键不小于k的元素移到right中
+    void split(const key_type& k, rb_tree& right) {
+        split(lower_bound(k), right);
+    }
+    // right的元素接在本树后面，要求它们都不小于本树的元素，right变空
+    void join(rb_tree& right);
+
+    //集合运算，只用于键唯一的树。m、n是两棵树中较小、较大的元素个数时
+    //为O(m log(n/m + 1))，而逐个插入删除要O(m log n)；
+    //递归地用对方子树根的键分裂本树，处理好两边后再连接起来
+    //本树变为与x的并集，x的节点都移过来，键已存在的销毁，x变空
+    void set_union(rb_tree& x);
+    //只留下x中也有的键
+    void set_intersection(const rb_tree& x);
+    //去掉x中也有的键
+    void set_difference(const rb_tree& x);
 
     void erase(iterator position);
     size_type erase(const key_type& x);
@@ -496,9 +929,9 @@ class rb_tree {
     void clear() {
         if (node_count != 0) {
             __erase(root());
-            leftmost() = header;
-            root() = 0;
-            rightmost() = header;
+            header_node.left = header();
+            header_node.parent = 0;
+            header_node.right = header();
             node_count = 0;
         }
     }
@@ -515,156 +948,533 @@ class rb_tree {
     std::pair<iterator, iterator> equal_range(const key_type& x);
     std::pair<const_iterator, const_iterator> equal_range(const key_type& x) const;
 
+    //比较器定义了is_transparent时，可以用任何能和键比较的类型查找，
+    //例如用const char*查std::string的键，不必先构造一个临时的键
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator find(const K& x) {
+        link_type y = __lower_bound(x);
+        return y == header() || key_compare(x, key(y)) ? end() : iterator(y);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator find(const K& x) const {
+        link_type y = __lower_bound(x);
+        return y == header() || key_compare(x, key(y)) ? end()
+                                                       : const_iterator(y);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    size_type count(const K& x) const {
+        return TinySTL::distance(const_iterator(__lower_bound(x)),
+                                 const_iterator(__upper_bound(x)));
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator lower_bound(const K& x) {
+        return __lower_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator lower_bound(const K& x) const {
+        return __lower_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator upper_bound(const K& x) {
+        return __upper_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    const_iterator upper_bound(const K& x) const {
+        return __upper_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& x) {
+        return std::pair<iterator, iterator>(__lower_bound(x),
+                                             __upper_bound(x));
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
+        return std::pair<const_iterator, const_iterator>(__lower_bound(x),
+                                                         __upper_bound(x));
+    }
+
+   private:
+    //第一个不小于x、第一个大于x的节点，没有时返回header
+    template <class K>
+    link_type __lower_bound(const K& x) const {
+        link_type y = header();
+        link_type z = root();
+        while (z != 0)
+            if (!key_compare(key(z), x))
+                y = z, z = left(z);
+            else
+                z = right(z);
+        return y;
+    }
+    template <class K>
+    link_type __upper_bound(const K& x) const {
+        link_type y = header();
+        link_type z = root();
+        while (z != 0)
+            if (key_compare(x, key(z)))
+                y = z, z = left(z);
+            else
+                z = right(z);
+        return y;
+    }
+
+   public:
+    // order statistics，只在NodeBase为__rb_tree_rank_node_base时可用
+    //第k小的元素（从0开始），k >= size()时返回end()
+    iterator select(size_type k) { return __select(k); }
+    const_iterator select(size_type k) const { return __select(k); }
+    //小于x的元素个数，即lower_bound(x)的序号
+    size_type rank(const key_type& x) const;
+    // position之前的元素个数，end()为size()
+    size_type index_of(const_iterator position) const;
+    difference_type distance(const_iterator first, const_iterator last) const {
+        return difference_type(index_of(last)) -
+               difference_type(index_of(first));
+    }
+
+   private:
+    link_type __select(size_type k) const;
+
    public:
     // Debugging.
     bool __rb_verify() const;
 };
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
 inline bool operator==(
-    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x,
-    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
-    return x.size() == y.size() && equal(x.begin(), x.end(), y.begin());
+    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& x,
+    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& y) {
+    return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
 inline bool operator<(
-    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x,
-    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
-    return lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& x,
+    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& y) {
+    return std::lexicographical_compare(x.begin(), x.end(), y.begin(),
+                                        y.end());
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::operator=(
-    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>&
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::operator=(
+    const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>& x) {
     if (this != &x) {
         // Note that Key may be a constant type.
         clear();
         node_count = 0;
         key_compare = x.key_compare;
         if (x.root() == 0) {
-            root() = 0;
-            leftmost() = header;
-            rightmost() = header;
+            header_node.parent = 0;
+            header_node.left = header();
+            header_node.right = header();
         } else {
-            root() = __copy(x.root(), header);
-            leftmost() = minimum(root());
-            rightmost() = maximum(root());
+            header_node.parent = __copy(x.root(), header());
+            header_node.left = minimum(root());
+            header_node.right = maximum(root());
             node_count = x.node_count;
         }
     }
     return *this;
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert(base_ptr x_,
-                                                          base_ptr y_,
-                                                          const Value& v) {
-    link_type x = (link_type)x_;
-    link_type y = (link_type)y_;
-    link_type z;
-
-    if (y == header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
-        z = create_node(v);
-        left(y) = z;  // also makes leftmost() = z when y == header
-        if (y == header) {
-            root() = z;
-            rightmost() = z;
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__link(
+    base_ptr x, base_ptr y, link_type z) {
+    if (y == header() || x != 0 || key_compare(key(z), key(y))) {
+        y->left = z;  // also makes leftmost() = z when y == header
+        if (y == header()) {
+            header_node.parent = z;
+            header_node.right = z;
         } else if (y == leftmost())
-            leftmost() = z;  // maintain leftmost() pointing to min node
+            header_node.left = z;  // maintain leftmost() pointing to min node
     } else {
-        z = create_node(v);
-        right(y) = z;
+        y->right = z;
         if (y == rightmost())
-            rightmost() = z;  // maintain rightmost() pointing to max node
+            header_node.right = z;  // maintain rightmost() pointing to max node
     }
-    parent(z) = y;
-    left(z) = 0;
-    right(z) = 0;
-    __rb_tree_rebalance(z, header->parent);
+    z->parent = y;
+    z->left = 0;
+    z->right = 0;
+    NodeBase::inserted(z, header_node.parent);
+    __rb_tree_rebalance<NodeBase>(z, header_node.parent);
     ++node_count;
     return iterator(z);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(const Value& v) {
-    link_type y = header;
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::insert_equal(
+    const Value& v) {
+    std::pair<base_ptr, base_ptr> pos = __insert_equal_pos(KeyOfValue()(v));
+    return __insert(pos.first, pos.second, v);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+std::pair<__rb_tree_node_base*, __rb_tree_node_base*>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__insert_equal_pos(
+    const Key& k) {
+    link_type y = header();
     link_type x = root();
     while (x != 0) {
         y = x;
-        x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
+        x = key_compare(k, key(x)) ? left(x) : right(x);
     }
-    return __insert(x, y, v);
+    return std::pair<base_ptr, base_ptr>(x, y);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-std::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator,
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+std::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                           NodeBase>::iterator,
           bool>
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const Value& v) {
-    link_type y = header;
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::insert_unique(
+    const Value& v) {
+    std::pair<base_ptr, base_ptr> pos = __insert_unique_pos(KeyOfValue()(v));
+    if (pos.second)
+        return std::pair<iterator, bool>(__insert(pos.first, pos.second, v),
+                                         true);
+    return std::pair<iterator, bool>(iterator((link_type)pos.first), false);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+std::pair<__rb_tree_node_base*, __rb_tree_node_base*>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__insert_unique_pos(
+    const Key& k) {
+    link_type y = header();
     link_type x = root();
     bool comp = true;
     while (x != 0) {
         y = x;
-        comp = key_compare(KeyOfValue()(v), key(x));  // v是否比当前节点小
-        x = comp ? left(x) : right(x)
+        comp = key_compare(k, key(x));  // k是否比当前节点小
+        x = comp ? left(x) : right(x);
     }
     iterator j = iterator(y);  // j指向父节点
     if (comp)                  //比父节点小
         if (j == begin())      //如果父节点是最左端
-            return pair<iterator, bool>(__insert(x, y, v), true);
+            return std::pair<base_ptr, base_ptr>(x, y);
         else
             --j;
-    if (key_compare(key(j.node), KeyOfValue()(v)))
-        return pair<iterator, bool>(__insert(x, y, v), true);
-    return pair<iterator, bool>(j, false);
+    if (key_compare(key(j.node), k)) return std::pair<base_ptr, base_ptr>(x, y);
+    return std::pair<base_ptr, base_ptr>(j.node, 0);
 }
 
-template <class Key, class Val, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::insert_unique(iterator position,
-                                                             const Val& v) {
-    if (position.node == header->left)  // begin()
-        if (size() > 0 && key_compare(KeyOfValue()(v), key(position.node)))
-            return __insert(position.node, position.node, v);
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+std::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                           NodeBase>::iterator,
+          bool>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::insert_unique(
+    node_type&& nh) {
+    if (nh.empty()) return std::pair<iterator, bool>(end(), false);
+    std::pair<base_ptr, base_ptr> pos = __insert_unique_pos(key(nh.node));
+    if (pos.second)
+        return std::pair<iterator, bool>(
+            __link(pos.first, pos.second, nh.release()), true);
+    return std::pair<iterator, bool>(iterator((link_type)pos.first), false);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::insert_equal(
+    node_type&& nh) {
+    if (nh.empty()) return end();
+    std::pair<base_ptr, base_ptr> pos = __insert_equal_pos(key(nh.node));
+    return __link(pos.first, pos.second, nh.release());
+}
+
+//先取后继再摘节点，摘下的节点直接挂到本树上
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+template <class Compare2>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::merge_unique(
+    rb_tree<Key, Value, KeyOfValue, Compare2, Alloc, NodeBase>& src) {
+    typedef typename rb_tree<Key, Value, KeyOfValue, Compare2, Alloc,
+                             NodeBase>::iterator src_iterator;
+    for (src_iterator i = src.begin(); i != src.end();) {
+        base_ptr z = (i++).node;
+        std::pair<base_ptr, base_ptr> pos = __insert_unique_pos(key(z));
+        if (pos.second) __link(pos.first, pos.second, src.__unlink(z));
+    }
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+template <class Compare2>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::merge_equal(
+    rb_tree<Key, Value, KeyOfValue, Compare2, Alloc, NodeBase>& src) {
+    typedef typename rb_tree<Key, Value, KeyOfValue, Compare2, Alloc,
+                             NodeBase>::iterator src_iterator;
+    for (src_iterator i = src.begin(); i != src.end();) {
+        base_ptr z = (i++).node;
+        std::pair<base_ptr, base_ptr> pos = __insert_equal_pos(key(z));
+        __link(pos.first, pos.second, src.__unlink(z));
+    }
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::split(
+    iterator position, rb_tree& right) {
+    right.clear();
+    if (position.node == header()) return;
+    size_type n = __count_to_end(position.node, (NodeBase*)0);
+    base_ptr l, r;
+    int hl, hr;
+    __rb_tree_split<NodeBase>(position.node, root(), l, hl, r, hr);
+    __reset_root(l, node_count - n);
+    right.__reset_root(r, n);
+}
+
+//摘下right中最小的节点作中间节点
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::join(
+    rb_tree& right) {
+    if (right.empty()) return;
+    base_ptr k = right.__unlink(right.leftmost());
+    size_type n = node_count + right.node_count + 1;
+    int h;
+    base_ptr r = __rb_tree_join<NodeBase>(
+        root(), __rb_tree_black_height(root()), k, right.root(),
+        __rb_tree_black_height(right.root()), h);
+    right.__reset_root(0, 0);
+    __reset_root(r, n);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::size_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__count_to_end(
+    base_ptr position, __rb_tree_node_base*) const {
+    const_iterator f = (link_type)position, b = f;
+    for (size_type n = 0;; ++n, ++f, --b) {
+        if (f.node == header()) return n;
+        if (b.node == leftmost()) return node_count - n;
+    }
+}
+
+//按键k把黑高度为h的子树x分成键小于k的l和大于k的r，
+//和k相等的节点摘下来放在m中，没有时为0
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__split_key(
+    base_ptr x, int h, const Key& k, base_ptr& l, int& hl, base_ptr& m,
+    base_ptr& r, int& hr) {
+    if (x == 0) {
+        l = m = r = 0;
+        hl = hr = 0;
+        return;
+    }
+    int hc = h - (x->color == __rb_tree_black);
+    if (key_compare(k, key(x))) {
+        base_ptr xr = x->right;
+        __split_key(x->left, hc, k, l, hl, m, r, hr);
+        r = __rb_tree_join<NodeBase>(r, hr, x, xr, hc, hr);
+    } else if (key_compare(key(x), k)) {
+        base_ptr xl = x->left;
+        __split_key(x->right, hc, k, l, hl, m, r, hr);
+        l = __rb_tree_join<NodeBase>(xl, hc, x, l, hl, hl);
+    } else {
+        l = x->left;
+        r = x->right;
+        hl = hr = hc;
+        m = x;
+    }
+}
+
+//键相同时留下本树的节点，u销毁
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::base_ptr
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__union(
+    base_ptr t, int ht, base_ptr u, int hu, int& h, size_type& n) {
+    if (u == 0) {
+        h = ht;
+        return t;
+    }
+    if (t == 0) {
+        h = hu;
+        return u;
+    }
+    int hc = hu - (u->color == __rb_tree_black);
+    base_ptr ul = u->left, ur = u->right;
+    base_ptr l, m, r;
+    int hl, hr;
+    __split_key(t, ht, key(u), l, hl, m, r, hr);
+    l = __union(l, hl, ul, hc, hl, n);
+    r = __union(r, hr, ur, hc, hr, n);
+    if (m) {
+        destroy_node((link_type)u);
+        ++n;
+        u = m;
+    }
+    return __rb_tree_join<NodeBase>(l, hl, u, r, hr, h);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::base_ptr
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__intersection(
+    base_ptr t, int ht, base_ptr u, int hu, int& h, size_type& n) {
+    h = 0;
+    if (t == 0) return 0;
+    if (u == 0) {
+        __erase((link_type)t);
+        return 0;
+    }
+    int hc = hu - (u->color == __rb_tree_black);
+    base_ptr l, m, r;
+    int hl, hr;
+    __split_key(t, ht, key(u), l, hl, m, r, hr);
+    l = __intersection(l, hl, u->left, hc, hl, n);
+    r = __intersection(r, hr, u->right, hc, hr, n);
+    if (m == 0) return __rb_tree_join2<NodeBase>(l, hl, r, hr, h);
+    ++n;
+    return __rb_tree_join<NodeBase>(l, hl, m, r, hr, h);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::base_ptr
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__difference(
+    base_ptr t, int ht, base_ptr u, int hu, int& h, size_type& n) {
+    h = ht;
+    if (t == 0 || u == 0) return t;
+    int hc = hu - (u->color == __rb_tree_black);
+    base_ptr l, m, r;
+    int hl, hr;
+    __split_key(t, ht, key(u), l, hl, m, r, hr);
+    l = __difference(l, hl, u->left, hc, hl, n);
+    r = __difference(r, hr, u->right, hc, hr, n);
+    if (m) {
+        destroy_node((link_type)m);
+        ++n;
+    }
+    return __rb_tree_join2<NodeBase>(l, hl, r, hr, h);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::set_union(
+    rb_tree& x) {
+    if (this == &x) return;
+    if (x.node_count <= node_count / 128) {  //见set_difference
+        merge_unique(x);
+        x.clear();
+        return;
+    }
+    size_type n = 0;
+    int h;
+    base_ptr r = __union(root(), __rb_tree_black_height(root()), x.root(),
+                         __rb_tree_black_height(x.root()), h, n);
+    n = node_count + x.node_count - n;
+    x.__reset_root(0, 0);
+    __reset_root(r, n);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+             NodeBase>::set_intersection(const rb_tree& x) {
+    if (this == &x) return;
+    size_type n = 0;
+    int h;
+    base_ptr r =
+        __intersection(root(), __rb_tree_black_height(root()), x.root(),
+                       __rb_tree_black_height(x.root()), h, n);
+    __reset_root(r, n);
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::set_difference(
+    const rb_tree& x) {
+    if (this == &x) {
+        clear();
+        return;
+    }
+    // x比本树小两个数量级以上时两种做法都是O(m log n)，逐个删除的常数小
+    if (x.node_count <= node_count / 128) {
+        for (const_iterator i = x.begin(); i != x.end(); ++i) {
+            iterator j = find(KeyOfValue()(*i));
+            if (j != end()) erase(j);
+        }
+        return;
+    }
+    size_type n = 0;
+    int h;
+    base_ptr r = __difference(root(), __rb_tree_black_height(root()),
+                              x.root(), __rb_tree_black_height(x.root()), h,
+                              n);
+    __reset_root(r, node_count - n);
+}
+
+template <class Key, class Val, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Val, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Val, KeyOfValue, Compare, Alloc, NodeBase>::insert_unique(
+    iterator position, const Val& v) {
+    std::pair<base_ptr, base_ptr> pos =
+        __insert_hint_unique_pos(position, KeyOfValue()(v));
+    if (pos.second) return __insert(pos.first, pos.second, v);
+    return iterator((link_type)pos.first);
+}
+
+template <class Key, class Val, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+std::pair<__rb_tree_node_base*, __rb_tree_node_base*>
+rb_tree<Key, Val, KeyOfValue, Compare, Alloc, NodeBase>::
+    __insert_hint_unique_pos(iterator position, const Key& k) {
+    typedef std::pair<base_ptr, base_ptr> pos_type;
+    if (position.node == header_node.left)  // begin()
+        if (size() > 0 && key_compare(k, key(position.node)))
+            return pos_type(position.node, position.node);
         // first argument just needs to be non-null
         else
-            return insert_unique(v).first;
-    else if (position.node == header)  // end()
-        if (key_compare(key(rightmost()), KeyOfValue()(v)))
-            return __insert(0, rightmost(), v);
+            return __insert_unique_pos(k);
+    else if (position.node == header())  // end()
+        if (size() > 0 && key_compare(key(rightmost()), k))
+            return pos_type(0, rightmost());
         else
-            return insert_unique(v).first;
+            return __insert_unique_pos(k);
     else {
         iterator before = position;
         --before;
-        if (key_compare(key(before.node), KeyOfValue()(v)) &&
-            key_compare(KeyOfValue()(v), key(position.node)))
+        if (key_compare(key(before.node), k) &&
+            key_compare(k, key(position.node)))
             if (right(before.node) == 0)
-                return __insert(0, before.node, v);
+                return pos_type(0, before.node);
             else
-                return __insert(position.node, position.node, v);
+                return pos_type(position.node, position.node);
         // first argument just needs to be non-null
         else
-            return insert_unique(v).first;
+            return __insert_unique_pos(k);
     }
 }
 
-template <class Key, class Val, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::insert_equal(iterator position,
-                                                            const Val& v) {
-    if (position.node == header->left)  // begin()
+template <class Key, class Val, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Val, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Val, KeyOfValue, Compare, Alloc, NodeBase>::insert_equal(
+    iterator position, const Val& v) {
+    if (position.node == header_node.left)  // begin()
         if (size() > 0 && key_compare(KeyOfValue()(v), key(position.node)))
             return __insert(position.node, position.node, v);
         // first argument just needs to be non-null
         else
             return insert_equal(v);
-    else if (position.node == header)  // end()
-        if (!key_compare(KeyOfValue()(v), key(rightmost())))
+    else if (position.node == header())  // end()
+        if (size() > 0 && !key_compare(KeyOfValue()(v), key(rightmost())))
             return __insert(0, rightmost(), v);
         else
             return insert_equal(v);
@@ -683,45 +1493,122 @@ rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::insert_equal(iterator position,
     }
 }
 
-template <class K, class V, class KoV, class Cmp, class Al>
+//逐个插入，以end()为提示，已排序时每次插入不需要从根查找
+template <class K, class V, class KoV, class Cmp, class Al, class NodeBase>
 template <class II>
-void rb_tree<K, V, KoV, Cmp, Al>::insert_equal(II first, II last) {
-    for (; first != last; ++first) insert_equal(*first);
+void rb_tree<K, V, KoV, Cmp, Al, NodeBase>::__insert_range(
+    II first, II last, bool unique, input_iterator_tag) {
+    for (; first != last; ++first)
+        if (unique)
+            insert_unique(end(), *first);
+        else
+            insert_equal(end(), *first);
 }
 
-template <class K, class V, class KoV, class Cmp, class Al>
-template <class II>
-void rb_tree<K, V, KoV, Cmp, Al>::insert_unique(II first, II last) {
-    for (; first != last; ++first) insert_unique(*first);
+template <class K, class V, class KoV, class Cmp, class Al, class NodeBase>
+template <class FI>
+void rb_tree<K, V, KoV, Cmp, Al, NodeBase>::__insert_range(
+    FI first, FI last, bool unique, forward_iterator_tag) {
+    size_type n = 0;
+    if (node_count != 0 || !__sorted_count(first, last, unique, n)) {
+        __insert_range(first, last, unique, input_iterator_tag());
+        return;
+    }
+    if (n == 0) return;
+    //前red_depth层是满的，第red_depth层的节点涂红，其余涂黑，
+    //所有叶子都在最后两层，每条路径上的黑节点数相同
+    size_type red_depth = 0;
+    while ((size_type(2) << red_depth) - 1 <= n) ++red_depth;
+    header_node.parent = __build(first, last, n, 0, red_depth, unique);
+    root()->parent = header();
+    header_node.left = minimum(root());
+    header_node.right = maximum(root());
+    node_count = n;
+}
+
+//检查区间是否按key_compare有序（unique时允许相邻重复），n返回要建的节点数
+template <class K, class V, class KoV, class Cmp, class Al, class NodeBase>
+template <class FI>
+bool rb_tree<K, V, KoV, Cmp, Al, NodeBase>::__sorted_count(
+    FI first, FI last, bool unique, size_type& n) const {
+    n = 0;
+    if (first == last) return true;
+    n = 1;
+    for (FI prev = first; ++first != last; prev = first) {
+        if (key_compare(KoV()(*first), KoV()(*prev))) return false;
+        if (!unique || key_compare(KoV()(*prev), KoV()(*first))) ++n;
+    }
+    return true;
+}
+
+//按中序从first取n个节点建成子树，左右子树大小最多差1
+template <class K, class V, class KoV, class Cmp, class Al, class NodeBase>
+template <class FI>
+typename rb_tree<K, V, KoV, Cmp, Al, NodeBase>::link_type
+rb_tree<K, V, KoV, Cmp, Al, NodeBase>::__build(
+    FI& first, FI last, size_type n, size_type depth, size_type red_depth,
+    bool unique) {
+    if (n == 0) return 0;
+    size_type left_n = (n - 1) / 2;
+    link_type l = __build(first, last, left_n, depth + 1, red_depth, unique);
+    link_type x;
+    try {
+        x = create_node(*first);
+    }
+    catch (...) {  //已经建好的左子树还没有挂到树上，由这里释放
+        __erase(l);
+        throw;
+    }
+    x->color = depth == red_depth ? __rb_tree_red : __rb_tree_black;
+    x->left = l;
+    if (l) l->parent = x;
+    x->right = 0;
+    link_type r;
+    try {
+        ++first;
+        if (unique)  //跳过与x相等的重复元素
+            while (first != last && !key_compare(key(x), KoV()(*first)))
+                ++first;
+        r = __build(first, last, n - 1 - left_n, depth + 1, red_depth,
+                    unique);
+    }
+    catch (...) {
+        __erase(x);
+        throw;
+    }
+    x->right = r;
+    if (r) r->parent = x;
+    NodeBase::update(x);
+    return x;
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-inline void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+inline void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::erase(
     iterator position) {
-    link_type y = (link_type)__rb_tree_rebalance_for_erase(
-        position.node, header->parent, header->left, header->right);
-    destroy_node(y);
-    --node_count;
+    destroy_node(__unlink(position.node));
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const Key& x) {
-    pair<iterator, iterator> p = equal_range(x);
-    size_type n = 0;
-    distance(p.first, p.second, n);
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::size_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::erase(const Key& x) {
+    std::pair<iterator, iterator> p = equal_range(x);
+    size_type n = TinySTL::distance(p.first, p.second);
     erase(p.first, p.second);
     return n;
 }
 
-template <class K, class V, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<K, V, KeyOfValue, Compare, Alloc>::link_type
-rb_tree<K, V, KeyOfValue, Compare, Alloc>::__copy(link_type x, link_type p) {
+template <class K, class V, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<K, V, KeyOfValue, Compare, Alloc, NodeBase>::link_type
+rb_tree<K, V, KeyOfValue, Compare, Alloc, NodeBase>::__copy(
+    link_type x, link_type p) {
     // structural copy.  x and p must be non-null.
     link_type top = clone_node(x);
     top->parent = p;
 
-    __STL_TRY {
+    try {
         if (x->right) top->right = __copy(right(x), top);
         p = top;
         x = left(x);
@@ -735,13 +1622,18 @@ rb_tree<K, V, KeyOfValue, Compare, Alloc>::__copy(link_type x, link_type p) {
             x = left(x);
         }
     }
-    __STL_UNWIND(__erase(top));
+    catch (...) {
+        __erase(top);
+        throw;
+    }
 
     return top;
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__erase(link_type x) {
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__erase(
+    link_type x) {
     // erase without rebalancing
     while (x != 0) {
         __erase(right(x));
@@ -751,25 +1643,48 @@ void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__erase(link_type x) {
     }
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator first,
-                                                            iterator last) {
-    if (first == begin() && last == end())
+//长区间在first和last处分裂，中间一段整个销毁，不用逐个摘下再调整，
+//两头再连接起来，O(log n + 删除的元素个数)。逐个删除时调整平均是O(1)的，
+//分裂和连接的固定开销要到上千个元素才划算，短区间仍然逐个删除
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::erase(
+    iterator first, iterator last) {
+    if (first == begin() && last == end()) {
         clear();
-    else
+        return;
+    }
+    size_type n = 0;
+    iterator i = first;
+    for (; i != last && n < 1024; ++i) ++n;
+    if (i == last) {
         while (first != last) erase(first++);
+        return;
+    }
+    n += TinySTL::distance(i, last);
+    base_ptr l, m, mid, r = 0;
+    int hl, hm, hr = 0;
+    __rb_tree_split<NodeBase>(first.node, root(), l, hl, m, hm);
+    mid = m;
+    if (last != end())
+        __rb_tree_split<NodeBase>(last.node, m, mid, hm, r, hr);
+    __erase((link_type)mid);
+    l = __rb_tree_join2<NodeBase>(l, hl, r, hr, hl);
+    __reset_root(l, node_count - n);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const Key* first,
-                                                            const Key* last) {
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::erase(
+    const Key* first, const Key* last) {
     while (first != last) erase(*first++);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) {
-    link_type y = header;  // Last node which is not less than k.
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::find(const Key& k) {
+    link_type y = header();  // Last node which is not less than k.
     link_type x = root();  // Current node.
 
     while (x != 0)
@@ -782,10 +1697,13 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) {
     return (j == end() || key_compare(k, key(j.node))) ? end() : j;
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) const {
-    link_type y = header; /* Last node which is not less than k. */
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                 NodeBase>::const_iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::find(
+    const Key& k) const {
+    link_type y = header(); /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
     while (x != 0) {
@@ -798,19 +1716,21 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const Key& k) const {
     return (j == end() || key_compare(k, key(j.node))) ? end() : j;
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::count(const Key& k) const {
-    pair<const_iterator, const_iterator> p = equal_range(k);
-    size_type n = 0;
-    distance(p.first, p.second, n);
-    return n;
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::size_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::count(
+    const Key& k) const {
+    std::pair<const_iterator, const_iterator> p = equal_range(k);
+    return TinySTL::distance(p.first, p.second);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) {
-    link_type y = header; /* Last node which is not less than k. */
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::lower_bound(
+    const Key& k) {
+    link_type y = header(); /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
     while (x != 0)
@@ -822,11 +1742,13 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(const Key& k) {
     return iterator(y);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                 NodeBase>::const_iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::lower_bound(
     const Key& k) const {
-    link_type y = header; /* Last node which is not less than k. */
+    link_type y = header(); /* Last node which is not less than k. */
     link_type x = root(); /* Current node. */
 
     while (x != 0)
@@ -838,10 +1760,12 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::lower_bound(
     return const_iterator(y);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) {
-    link_type y = header; /* Last node which is greater than k. */
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::upper_bound(
+    const Key& k) {
+    link_type y = header(); /* Last node which is greater than k. */
     link_type x = root(); /* Current node. */
 
     while (x != 0)
@@ -853,11 +1777,13 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(const Key& k) {
     return iterator(y);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::const_iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                 NodeBase>::const_iterator
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::upper_bound(
     const Key& k) const {
-    link_type y = header; /* Last node which is greater than k. */
+    link_type y = header(); /* Last node which is greater than k. */
     link_type x = root(); /* Current node. */
 
     while (x != 0)
@@ -869,18 +1795,77 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::upper_bound(
     return const_iterator(y);
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-inline std::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator,
-            typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator>
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::equal_range(const Key& k) {
-    return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+inline std::pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                                  NodeBase>::iterator,
+            typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc,
+                             NodeBase>::iterator>
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::equal_range(
+    const Key& k) {
+    return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+}
+
+template <class Key, class Value, class KoV, class Compare, class Alloc,
+          class NodeBase>
+inline std::pair<typename rb_tree<Key, Value, KoV, Compare, Alloc,
+                                  NodeBase>::const_iterator,
+            typename rb_tree<Key, Value, KoV, Compare, Alloc,
+                             NodeBase>::const_iterator>
+rb_tree<Key, Value, KoV, Compare, Alloc, NodeBase>::equal_range(
+    const Key& k) const {
+    return std::pair<const_iterator, const_iterator>(lower_bound(k),
+                                                     upper_bound(k));
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::link_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__select(
+    size_type k) const {
+    link_type x = root();
+    while (x != 0) {
+        size_type l = NodeBase::size_of(x->left);
+        if (k < l)
+            x = left(x);
+        else if (k == l)
+            return x;
+        else {
+            k -= l + 1;
+            x = right(x);
+        }
+    }
+    return header();
+}
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::size_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::rank(
+    const Key& k) const {
+    size_type n = 0;
+    link_type x = root();
+    while (x != 0)
+        if (key_compare(key(x), k)) {
+            n += NodeBase::size_of(x->left) + 1;
+            x = right(x);
+        } else
+            x = left(x);
+    return n;
 }
 
-template <class Key, class Value, class KoV, class Compare, class Alloc>
-inline std::pair<typename rb_tree<Key, Value, KoV, Compare, Alloc>::const_iterator,
-            typename rb_tree<Key, Value, KoV, Compare, Alloc>::const_iterator>
-rb_tree<Key, Value, KoV, Compare, Alloc>::equal_range(const Key& k) const {
-    return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+//从position往上走到根，每次从右子树上来就加上父节点及其左子树
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::size_type
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::index_of(
+    const_iterator position) const {
+    base_ptr x = position.node;
+    if (x == header()) return node_count;
+    size_type n = NodeBase::size_of(x->left);
+    for (; x != root(); x = x->parent)
+        if (x == x->parent->right) n += NodeBase::size_of(x->parent->left) + 1;
+    return n;
 }
 
 inline int __black_count(__rb_tree_node_base* node, __rb_tree_node_base* root) {
@@ -895,11 +1880,13 @@ inline int __black_count(__rb_tree_node_base* node, __rb_tree_node_base* root) {
     }
 }
 
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-bool rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__rb_verify() const {
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc,
+          class NodeBase>
+bool rb_tree<Key, Value, KeyOfValue, Compare, Alloc, NodeBase>::__rb_verify()
+    const {
     if (node_count == 0 || begin() == end())
-        return node_count == 0 && begin() == end() && header->left == header &&
-               header->right == header;
+        return node_count == 0 && begin() == end() &&
+               header_node.left == header() && header_node.right == header();
 
     int len = __black_count(leftmost(), root());
     for (const_iterator it = begin(); it != end(); ++it) {
@@ -916,6 +1903,7 @@ bool rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__rb_verify() const {
         if (R && key_compare(key(R), key(x))) return false;
 
         if (!L && !R && __black_count(x, root()) != len) return false;
+        if (!NodeBase::verify(x)) return false;
     }
 
     if (leftmost() != __rb_tree_node_base::minimum(root())) return false;
@@ -1,14 +1,32 @@
 #ifndef SET_H__
 #define SET_H__
 
+#include <functional>
+#include <utility>
 #include "Alloc.h"
 #include "Construct.h"
+#include "Function.h"
 #include "RB_Tree.h"
 
 namespace TinySTL {
 
-template <class Key, class Compare = std::less<Key>, class Alloc = alloc>
+// NodeBase用__rb_tree_rank_node_base时支持select/rank/distance，见ranked_set
+template <class Key, class Compare = std::less<Key>, class Alloc = alloc,
+          class NodeBase = __rb_tree_node_base>
+class set;
+
+template <class Key, class Compare, class Alloc, class NodeBase>
+bool operator==(const set<Key, Compare, Alloc, NodeBase>& x,
+                const set<Key, Compare, Alloc, NodeBase>& y);
+template <class Key, class Compare, class Alloc, class NodeBase>
+bool operator<(const set<Key, Compare, Alloc, NodeBase>& x,
+               const set<Key, Compare, Alloc, NodeBase>& y);
+
+template <class Key, class Compare, class Alloc, class NodeBase>
 class set {
+    template <class, class, class, class>
+    friend class set;
+
    public:
 
     typedef Key key_type;
@@ -18,9 +36,17 @@ class set {
 
    private:
     typedef rb_tree<key_type, value_type, identity<value_type>, key_compare,
-                    Alloc>
+                    Alloc, NodeBase>
         rep_type;
     rep_type t;  // red-black tree representing set
+    typedef typename rep_type::iterator rep_iterator;
+    //迭代器都是const的，交给rb_tree修改时转换成普通迭代器；
+    //按值转换，不把const_iterator对象当成iterator对象来读
+    static rep_iterator mutable_iterator(
+        typename rep_type::const_iterator position) {
+        return typename rep_type::link_type(position.node);
+    }
+
    public:
     typedef typename rep_type::const_pointer pointer;
     typedef typename rep_type::const_pointer const_pointer;
@@ -32,12 +58,14 @@ class set {
     typedef typename rep_type::const_reverse_iterator const_reverse_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;
+    typedef typename rep_type::node_type node_type;
 
     // allocation/deallocation
 
     set() : t(Compare()) {}
     explicit set(const Compare& comp) : t(comp) {}
 
+    //区间已排序时O(n)建树，见rb_tree::insert_unique
     template <class InputIterator>
     set(InputIterator first, InputIterator last) : t(Compare()) {
         t.insert_unique(first, last);
@@ -49,8 +77,9 @@ class set {
         t.insert_unique(first, last);
     }
 
-    set(const set<Key, Compare, Alloc>& x) : t(x.t) {}
-    set<Key, Compare, Alloc>& operator=(const set<Key, Compare, Alloc>& x) {
+    set(const set<Key, Compare, Alloc, NodeBase>& x) : t(x.t) {}
+    set<Key, Compare, Alloc, NodeBase>& operator=(
+        const set<Key, Compare, Alloc, NodeBase>& x) {
         t = x.t;
         return *this;
     }
@@ -66,53 +95,130 @@ class set {
     bool empty() const { return t.empty(); }
     size_type size() const { return t.size(); }
     size_type max_size() const { return t.max_size(); }
-    void swap(set<Key, Compare, Alloc>& x) { t.swap(x.t); }
+    void swap(set<Key, Compare, Alloc, NodeBase>& x) { t.swap(x.t); }
 
     // insert/erase
-    typedef pair<iterator, bool> pair_iterator_bool;
-    pair<iterator, bool> insert(const value_type& x) {
-        pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
-        return pair<iterator, bool>(p.first, p.second);
+    typedef std::pair<iterator, bool> pair_iterator_bool;
+    std::pair<iterator, bool> insert(const value_type& x) {
+        std::pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
+        return std::pair<iterator, bool>(p.first, p.second);
     }
     iterator insert(iterator position, const value_type& x) {
-        typedef typename rep_type::iterator rep_iterator;
-        return t.insert_unique((rep_iterator&)position, x);
+        return t.insert_unique(mutable_iterator(position), x);
     }
     template <class InputIterator>
     void insert(InputIterator first, InputIterator last) {
         t.insert_unique(first, last);
     }
+    //用args在节点里原地构造元素，键已存在时再销毁
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        std::pair<typename rep_type::iterator, bool> p =
+            t.emplace_unique(std::forward<Args>(args)...);
+        return std::pair<iterator, bool>(p.first, p.second);
+    }
+    template <class... Args>
+    iterator emplace_hint(iterator position, Args&&... args) {
+        return t.emplace_hint_unique(mutable_iterator(position),
+                                     std::forward<Args>(args)...);
+    }
 
     void erase(iterator position) {
-        typedef typename rep_type::iterator rep_iterator;
-        t.erase((rep_iterator&)position);
+        t.erase(mutable_iterator(position));
     }
     size_type erase(const key_type& x) { return t.erase(x); }
     void erase(iterator first, iterator last) {
-        typedef typename rep_type::iterator rep_iterator;
-        t.erase((rep_iterator&)first, (rep_iterator&)last);
+        t.erase(mutable_iterator(first), mutable_iterator(last));
     }
     void clear() { t.clear(); }
 
+    //在set之间搬动元素，不配置内存也不复制元素，见rb_tree::extract
+    node_type extract(iterator position) {
+        return t.extract(mutable_iterator(position));
+    }
+    node_type extract(const key_type& x) { return t.extract(x); }
+    //键已存在时不插入，节点留在nh中
+    std::pair<iterator, bool> insert(node_type&& nh) {
+        std::pair<typename rep_type::iterator, bool> p =
+            t.insert_unique(std::move(nh));
+        return std::pair<iterator, bool>(p.first, p.second);
+    }
+    template <class Compare2>
+    void merge(set<Key, Compare2, Alloc, NodeBase>& source) {
+        t.merge_unique(source.t);
+    }
+
+    //分裂与连接，O(log n)，见rb_tree::split
+    //不小于k的元素移到right中，right原有的元素被清除
+    void split(const key_type& k, set& right) { t.split(k, right.t); }
+    void split(iterator position, set& right) {
+        t.split(mutable_iterator(position), right.t);
+    }
+    // right的元素都要大于本set的元素，接过来以后right变空
+    void join(set& right) { t.join(right.t); }
+    //集合运算，O(m log(n/m + 1))，见rb_tree::set_union
+    void set_union(set& x) { t.set_union(x.t); }
+    void set_intersection(const set& x) { t.set_intersection(x.t); }
+    void set_difference(const set& x) { t.set_difference(x.t); }
+
     // set operations:
 
     iterator find(const key_type& x) const { return t.find(x); }
     size_type count(const key_type& x) const { return t.count(x); }
     iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
     iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
-    pair<iterator, iterator> equal_range(const key_type& x) const {
+    std::pair<iterator, iterator> equal_range(const key_type& x) const {
         return t.equal_range(x);
     }
-    friend bool operator== __STL_NULL_TMPL_ARGS(const set&, const set&);
-    friend bool operator<__STL_NULL_TMPL_ARGS(const set&, const set&);
+
+    //比较器有is_transparent时的异构查找，见rb_tree::find
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator find(const K& x) const {
+        return t.find(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    size_type count(const K& x) const {
+        return t.count(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator lower_bound(const K& x) const {
+        return t.lower_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    iterator upper_bound(const K& x) const {
+        return t.upper_bound(x);
+    }
+    template <class K, class C = Compare, class = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& x) const {
+        return t.equal_range(x);
+    }
+
+    // order statistics，只有ranked_set可用，都是O(log n)
+    iterator select(size_type k) const { return t.select(k); }
+    size_type rank(const key_type& x) const { return t.rank(x); }
+    difference_type distance(iterator first, iterator last) const {
+        return t.distance(first, last);
+    }
+    friend bool operator== <>(const set&, const set&);
+    friend bool operator< <>(const set&, const set&);
 };
 
-template <class Key, class Compare, class Alloc>
-inline bool operator==(const set<Key, Compare, Alloc>& x,
-                       const set<Key, Compare, Alloc>& y) {
+template <class Key, class Compare, class Alloc, class NodeBase>
+inline bool operator==(const set<Key, Compare, Alloc, NodeBase>& x,
+                       const set<Key, Compare, Alloc, NodeBase>& y) {
     return x.t == y.t;
 }
 
+template <class Key, class Compare, class Alloc, class NodeBase>
+inline bool operator<(const set<Key, Compare, Alloc, NodeBase>& x,
+                      const set<Key, Compare, Alloc, NodeBase>& y) {
+    return x.t < y.t;
 }
 
+//维护子树大小的set，每个节点多一个size_t
+template <class Key, class Compare = std::less<Key>, class Alloc = alloc>
+using ranked_set = set<Key, Compare, Alloc, __rb_tree_rank_node_base>;
+
+}  // namespace TinySTL
+
 #endif
\ No newline at end of file
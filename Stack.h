@@ -1,6 +1,9 @@
 #ifndef STACK_H__
 #define STACK_H__
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include "Alloc.h"
 #include "Construct.h"
 #include "Deque.h"
@@ -8,6 +11,14 @@
 namespace TinySTL {
 
 template <class T, class Sequence = deque<T> >
+class stack;
+
+template <class T, class Sequence>
+bool operator==(const stack<T, Sequence>& x, const stack<T, Sequence>& y);
+template <class T, class Sequence>
+bool operator<(const stack<T, Sequence>& x, const stack<T, Sequence>& y);
+
+template <class T, class Sequence>
 class stack {
     friend bool operator== <>(const stack&, const stack&);
     friend bool operator< <>(const stack&, const stack&);
@@ -40,6 +51,112 @@ bool operator<(const stack<T, Sequence>& x, const stack<T, Sequence>& y) {
     return x.c < y.c;
 }
 
+template <class T>
+struct __lf_stack_node {
+    std::atomic<uint32_t> next;  //下一个节点的编号，0表示没有
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return (T*)storage; }
+};
+
+//无锁的有界栈（Treiber栈）
+//节点在构造时一次配置好，空闲节点串成另一个同样无锁的链表，push/pop不调用分配器
+//链表头是64位的带版本号编号：低32位是节点编号+1（0表示空），
+//高32位每次修改加1，节点被弹出又压回时CAS也能发现，避免ABA问题
+//节点内存到析构才释放，读到被别的线程取走的节点的next也不会越界
+template <class T, class Alloc = malloc_alloc>
+class lock_free_stack {
+   public:
+    typedef T value_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef size_t size_type;
+
+   protected:
+    typedef __lf_stack_node<T> node;
+    typedef simple_alloc<node, Alloc> node_allocator;
+    enum { cache_line_size = 64 };
+
+    alignas(cache_line_size) std::atomic<uint64_t> top;        //元素链表
+    alignas(cache_line_size) std::atomic<uint64_t> free_top;   //空闲节点链表
+    alignas(cache_line_size) node* nodes;
+    size_type cap;
+
+    static uint64_t make_head(uint64_t old, uint32_t index) {
+        return ((old >> 32) + 1) << 32 | index;
+    }
+
+    //从链表头取下一个节点，返回编号+1，链表空时返回0
+    uint32_t pop_list(std::atomic<uint64_t>& list) {
+        uint64_t old = list.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t i = uint32_t(old);
+            if (i == 0) return 0;
+            uint32_t next = nodes[i - 1].next.load(std::memory_order_relaxed);
+            if (list.compare_exchange_weak(old, make_head(old, next),
+                                           std::memory_order_acquire,
+                                           std::memory_order_acquire))
+                return i;
+        }
+    }
+    void push_list(std::atomic<uint64_t>& list, uint32_t i) {
+        uint64_t old = list.load(std::memory_order_relaxed);
+        for (;;) {
+            nodes[i - 1].next.store(uint32_t(old), std::memory_order_relaxed);
+            if (list.compare_exchange_weak(old, make_head(old, i),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed))
+                return;
+        }
+    }
+
+   public:
+    //capacity不能超过2^32 - 1
+    explicit lock_free_stack(size_type capacity)
+        : top(0), free_top(capacity ? 1 : 0), cap(capacity) {
+        nodes = capacity ? node_allocator::allocate(capacity) : 0;
+        for (size_type i = 0; i < capacity; ++i)
+            construct(&nodes[i].next, uint32_t(i + 1 < capacity ? i + 2 : 0));
+    }
+    //析构时不能有其他线程在使用栈
+    ~lock_free_stack() {
+        for (uint32_t i = uint32_t(top.load(std::memory_order_relaxed)); i;
+             i = nodes[i - 1].next.load(std::memory_order_relaxed))
+            destroy(nodes[i - 1].value());
+        if (nodes) node_allocator::deallocate(nodes, cap);
+    }
+
+   private:
+    lock_free_stack(const lock_free_stack&);
+    lock_free_stack& operator=(const lock_free_stack&);
+
+   public:
+    size_type capacity() const { return cap; }
+    //其他线程可能同时在修改，结果只是当时的快照
+    bool empty() const {
+        return uint32_t(top.load(std::memory_order_acquire)) == 0;
+    }
+
+    //节点用完时返回false
+    bool try_push(const value_type& x) {
+        uint32_t i = pop_list(free_top);
+        if (i == 0) return false;
+        construct(nodes[i - 1].value(), x);
+        push_list(top, i);
+        return true;
+    }
+
+    //栈空时返回false
+    bool try_pop(reference x) {
+        uint32_t i = pop_list(top);
+        if (i == 0) return false;
+        x = *nodes[i - 1].value();
+        destroy(nodes[i - 1].value());
+        push_list(free_top, i);
+        return true;
+    }
+};
+
 }  // namespace TinySTL
 
 #endif
\ No newline at end of file
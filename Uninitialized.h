@@ -1,30 +1,19 @@
 #ifndef UNINITIALIZED_H__
 #define UNINITIALIZED_H__
 
+#include "Construct.h"
 #include "TypeTraits.h"
+#include <algorithm>
 #include <cstring>
 
 namespace TinySTL {
 
-template <class ForwardIterator, class Size, class T>
-inline ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n,
-                                            const T& x) {
-    return __uninitialized_fill_n(first, n, x, value_type(first));
-}
-
-template <class ForwardIterator, class Size, class T, class T1>
-inline ForwardIterator __uninitialized_fill_n(ForwardIterator first, Size n,
-                                              const T& x, T1*) {
-    typedef typename _type_traits<T1>::is_POD_type is_POD;
-    return __uninitialized_fill_n_aux(first, n, x, is_POD());
-}
-
 //验证拷贝构造函数是否与赋值操作符等同，并且判断析构函数是否为trivial的
 template <class ForwardIterator, class Size, class T>
 inline ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n,
                                                   const T& x, _true_type) {
     //对于POD对象
-    return fill_n(first, n, x);
+    return std::fill_n(first, n, x);
 }
 
 template <class ForwardIterator, class Size, class T>
@@ -36,6 +25,19 @@ ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n,
     return cur;
 }
 
+template <class ForwardIterator, class Size, class T, class T1>
+inline ForwardIterator __uninitialized_fill_n(ForwardIterator first, Size n,
+                                              const T& x, T1*) {
+    typedef typename _type_traits<T1>::is_POD_type is_POD;
+    return __uninitialized_fill_n_aux(first, n, x, is_POD());
+}
+
+template <class ForwardIterator, class Size, class T>
+inline ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n,
+                                            const T& x) {
+    return __uninitialized_fill_n(first, n, x, value_type(first));
+}
+
 template <class InputIterator, class ForwardIterator, class T>
 inline ForwardIterator __uninitialized_copy(InputIterator first,
                                             InputIterator last,
@@ -86,26 +88,13 @@ inline wchar_t* uninitialized_copy(const wchar_t* first, const wchar_t* last,
     return result + (last - first);
 }
 
-template <class ForwardIterator, class T>
-inline void uninitialized_fill(ForwardIterator first, ForwardIterator last,
-                               const T& x) {
-    __uninitialized_fill(first, last, x, value_type(first));
-}
-
-template <class ForwardIterator, class T, class T1>
-inline void __uninitialized_fill(ForwardIterator first, ForwardIterator last,
-                                 const T& x, T1*) {
-    typedef typename _type_traits<T1>::is_POD_type is_POD;
-    __uninitialized_fill_aux(first, last, x, is_POD());
-}
-
 //验证拷贝构造函数是否与赋值操作符等同，并且判断析构函数是否为trivial的
 template <class ForwardIterator, class T>
 inline void __uninitialized_fill_aux(ForwardIterator first,
                                      ForwardIterator last, const T& x,
                                      _true_type) {
     //对于POD对象
-    fill(first, last, x);
+    std::fill(first, last, x);
 }
 
 template <class ForwardIterator, class T>
@@ -116,6 +105,53 @@ void __uninitialized_fill_aux(ForwardIterator first, ForwardIterator last,
     for (; cur != last; ++cur) construct(&*cur, x);
 }
 
+template <class ForwardIterator, class T, class T1>
+inline void __uninitialized_fill(ForwardIterator first, ForwardIterator last,
+                                 const T& x, T1*) {
+    typedef typename _type_traits<T1>::is_POD_type is_POD;
+    __uninitialized_fill_aux(first, last, x, is_POD());
+}
+
+template <class ForwardIterator, class T>
+inline void uninitialized_fill(ForwardIterator first, ForwardIterator last,
+                               const T& x) {
+    __uninitialized_fill(first, last, x, value_type(first));
+}
+
+//将[first1, last1)和[first2, last2)依次拷贝到以result起始的区间中
+template <class InputIterator1, class InputIterator2, class ForwardIterator>
+inline ForwardIterator __uninitialized_copy_copy(InputIterator1 first1,
+                                                 InputIterator1 last1,
+                                                 InputIterator2 first2,
+                                                 InputIterator2 last2,
+                                                 ForwardIterator result) {
+    ForwardIterator mid =
+        TinySTL::uninitialized_copy(first1, last1, result);
+    return TinySTL::uninitialized_copy(first2, last2, mid);
+}
+
+//以x填充[result, mid)，再将[first, last)拷贝到mid起始的区间中
+template <class ForwardIterator, class T, class InputIterator>
+inline ForwardIterator __uninitialized_fill_copy(ForwardIterator result,
+                                                 ForwardIterator mid,
+                                                 const T& x,
+                                                 InputIterator first,
+                                                 InputIterator last) {
+    TinySTL::uninitialized_fill(result, mid, x);
+    return TinySTL::uninitialized_copy(first, last, mid);
+}
+
+//将[first1, last1)拷贝到first2起始的区间中，再以x填充剩余的[mid2, last2)
+template <class InputIterator, class ForwardIterator, class T>
+inline void __uninitialized_copy_fill(InputIterator first1,
+                                      InputIterator last1,
+                                      ForwardIterator first2,
+                                      ForwardIterator last2, const T& x) {
+    ForwardIterator mid2 =
+        TinySTL::uninitialized_copy(first1, last1, first2);
+    TinySTL::uninitialized_fill(mid2, last2, x);
+}
+
 }  // namespace TinySTL
 
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef UNORDEREDMAP_H__
+#define UNORDEREDMAP_H__
+
+#include <functional>
+#include <utility>
+#include "Alloc.h"
+#include "Function.h"
+#include "HashTable.h"
+
+namespace TinySTL {
+
+//键唯一的哈希表，平均O(1)查找，元素没有顺序
+//底层是开放寻址的hashtable，插入可能重新散列，使所有迭代器失效
+template <class Key, class T, class HashFcn = std::hash<Key>,
+          class EqualKey = std::equal_to<Key>, class Alloc = alloc>
+class unordered_map;
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+bool operator==(const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x,
+                const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& y);
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+class unordered_map {
+   public:
+    // typedefs:
+
+    typedef Key key_type;
+    typedef T data_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef HashFcn hasher;
+    typedef EqualKey key_equal;
+
+   private:
+    typedef hashtable<key_type, value_type, select1st<value_type>, hasher,
+                      key_equal, Alloc>
+        rep_type;
+    rep_type t;  // hash table representing unordered_map
+   public:
+    typedef typename rep_type::pointer pointer;
+    typedef typename rep_type::const_pointer const_pointer;
+    typedef typename rep_type::reference reference;
+    typedef typename rep_type::const_reference const_reference;
+    typedef typename rep_type::iterator iterator;
+    typedef typename rep_type::const_iterator const_iterator;
+    typedef typename rep_type::size_type size_type;
+    typedef typename rep_type::difference_type difference_type;
+
+    // allocation/deallocation
+
+    unordered_map() {}
+    explicit unordered_map(size_type n, const hasher& hf = hasher(),
+                           const key_equal& eql = key_equal())
+        : t(n, hf, eql) {}
+
+    template <class InputIterator>
+    unordered_map(InputIterator first, InputIterator last) {
+        t.insert_unique(first, last);
+    }
+
+    template <class InputIterator>
+    unordered_map(InputIterator first, InputIterator last, size_type n,
+                  const hasher& hf = hasher(),
+                  const key_equal& eql = key_equal())
+        : t(n, hf, eql) {
+        t.insert_unique(first, last);
+    }
+
+    // accessors:
+
+    hasher hash_function() const { return t.hash_funct(); }
+    key_equal key_eq() const { return t.key_eq(); }
+    iterator begin() { return t.begin(); }
+    const_iterator begin() const { return t.begin(); }
+    iterator end() { return t.end(); }
+    const_iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    T& operator[](const key_type& k) {
+        return (*((insert(value_type(k, T()))).first)).second;
+    }
+    void swap(unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x) {
+        t.swap(x.t);
+    }
+
+    // bucket interface:
+
+    size_type bucket_count() const { return t.bucket_count(); }
+    float load_factor() const { return t.load_factor(); }
+    float max_load_factor() const { return t.max_load_factor(); }
+    void max_load_factor(float f) { t.max_load_factor(f); }
+    void rehash(size_type n) { t.rehash(n); }
+    void reserve(size_type n) { t.reserve(n); }
+
+    // insert/erase
+
+    std::pair<iterator, bool> insert(const value_type& x) {
+        return t.insert_unique(x);
+    }
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        t.insert_unique(first, last);
+    }
+
+    void erase(const_iterator position) { t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(const_iterator first, const_iterator last) {
+        t.erase(first, last);
+    }
+    void clear() { t.clear(); }
+
+    // map operations:
+
+    iterator find(const key_type& x) { return t.find(x); }
+    const_iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    std::pair<iterator, iterator> equal_range(const key_type& x) {
+        return t.equal_range(x);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(
+        const key_type& x) const {
+        return t.equal_range(x);
+    }
+    friend bool operator== <>(const unordered_map&, const unordered_map&);
+};
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline bool operator==(
+    const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x,
+    const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& y) {
+    return x.t == y.t;
+}
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline bool operator!=(
+    const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x,
+    const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& y) {
+    return !(x == y);
+}
+
+template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+inline void swap(unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x,
+                 unordered_map<Key, T, HashFcn, EqualKey, Alloc>& y) {
+    x.swap(y);
+}
+
+}  // namespace TinySTL
+
+#endif
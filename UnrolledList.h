@@ -0,0 +1,315 @@
+#ifndef UNROLLEDLIST_H__
+#define UNROLLEDLIST_H__
+
+#include <algorithm>
+#include <cstddef>
+#include "Alloc.h"
+#include "Construct.h"
+#include "Uninitialized.h"
+
+namespace TinySTL {
+
+//每个节点存放最多N个元素，节点内元素连续存放在[0, count)
+struct __unrolled_node_base {
+    __unrolled_node_base* next;
+    __unrolled_node_base* prev;
+};
+
+template <class T, size_t N>
+struct __unrolled_node : public __unrolled_node_base {
+    size_t count;
+    alignas(T) unsigned char storage[sizeof(T) * N];  //未构造的原始空间
+
+    T* elems() { return (T*)storage; }
+};
+
+template <class T, class Ref, class Ptr, size_t N>
+struct __unrolled_list_iterator {
+    typedef __unrolled_list_iterator<T, T&, T*, N> iterator;
+    typedef __unrolled_list_iterator<T, Ref, Ptr, N> self;
+
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef __unrolled_node<T, N>* link_type;
+    typedef __unrolled_node_base* base_ptr;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    base_ptr node;     //可能指向内嵌的哨兵，只能当作base访问
+    size_type index;   //元素在节点中的下标，end()时为0
+
+    __unrolled_list_iterator(base_ptr x, size_type i) : node(x), index(i) {}
+    __unrolled_list_iterator() {}
+    __unrolled_list_iterator(const iterator& x)
+        : node(x.node), index(x.index) {}
+
+    bool operator==(const self& x) const {
+        return node == x.node && index == x.index;
+    }
+    bool operator!=(const self& x) const { return !(*this == x); }
+    reference operator*() const { return ((link_type)node)->elems()[index]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        if (++index == ((link_type)node)->count) {
+            node = node->next;
+            index = 0;
+        }
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        if (index == 0) {
+            node = node->prev;
+            index = ((link_type)node)->count;
+        }
+        --index;
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+};
+
+//展开链表：节点是N个元素的小数组，省掉每个元素的next/prev，遍历时按块访问
+//insert/erase只移动所在节点内的元素，N固定时为O(1)
+//插入可能拆分节点，删除可能合并节点，两者都会使该节点上的迭代器失效
+template <class T, size_t N = 16, class Alloc = alloc>
+class unrolled_list {
+   protected:
+    typedef __unrolled_node<T, N> list_node;
+    typedef __unrolled_node_base* base_ptr;
+    typedef simple_alloc<list_node, Alloc> list_node_allocator;
+
+   public:
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef list_node* link_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+   public:
+    typedef __unrolled_list_iterator<T, T&, T*, N> iterator;
+    typedef __unrolled_list_iterator<T, const T&, const T*, N> const_iterator;
+
+   protected:
+    //配置一个空节点并链到position前
+    link_type create_node(base_ptr position) {
+        link_type p = list_node_allocator::allocate();
+        p->count = 0;
+        p->next = position;
+        p->prev = position->prev;
+        position->prev->next = p;
+        position->prev = p;
+        return p;
+    }
+    //节点中的元素已析构，摘下并释放
+    void destroy_node(link_type p) {
+        p->prev->next = p->next;
+        p->next->prev = p->prev;
+        list_node_allocator::deallocate(p);
+    }
+    //把p中[k, count)搬到p之后的新节点，返回新节点
+    link_type split_node(link_type p, size_type k) {
+        link_type q = create_node(p->next);
+        T* e = p->elems();
+        TinySTL::uninitialized_copy(e + k, e + p->count, q->elems());
+        destroy(e + k, e + p->count);
+        q->count = p->count - k;
+        p->count = k;
+        return q;
+    }
+    //保证position落在节点边界上，返回从position开始的节点
+    base_ptr cut(iterator position) {
+        if (position.index == 0) return position.node;
+        return split_node((link_type)position.node, position.index);
+    }
+
+   protected:
+    __unrolled_node_base sentinel;  //内嵌哨兵，空链表不分配内存
+    size_type length;
+    base_ptr node() const { return (base_ptr)&sentinel; }
+    void empty_initialize() {
+        sentinel.next = node();
+        sentinel.prev = node();
+        length = 0;
+    }
+
+   public:
+    unrolled_list() { empty_initialize(); }
+    unrolled_list(const unrolled_list& x) {
+        empty_initialize();
+        for (base_ptr p = x.sentinel.next; p != x.node(); p = p->next) {
+            link_type src = (link_type)p;
+            link_type dst = create_node(node());
+            TinySTL::uninitialized_copy(src->elems(),
+                                        src->elems() + src->count,
+                                        dst->elems());
+            dst->count = src->count;
+            length += src->count;
+        }
+    }
+    ~unrolled_list() { clear(); }
+    unrolled_list& operator=(const unrolled_list& x) {
+        if (this != &x) {
+            unrolled_list tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    iterator begin() { return iterator(sentinel.next, 0); }
+    iterator end() { return iterator(node(), 0); }
+    const_iterator begin() const { return const_iterator(sentinel.next, 0); }
+    const_iterator end() const { return const_iterator(node(), 0); }
+    bool empty() const { return length == 0; }
+    size_type size() const { return length; }
+    reference front() { return *begin(); }
+    reference back() { return *(--end()); }
+
+    iterator insert(iterator position, const T& x);
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last);
+    void clear();
+    void swap(unrolled_list& x);
+
+    void push_front(const T& x) { insert(begin(), x); }
+    void push_back(const T& x) { insert(end(), x); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(--end()); }
+
+    //按节点搬移，只在切开position/first/last所在节点时移动元素，x必须不同
+    void splice(iterator position, unrolled_list& x) {
+        if (!x.empty()) splice(position, x, x.begin(), x.end());
+    }
+    void splice(iterator position, unrolled_list& x, iterator first,
+                iterator last);
+};
+
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::insert(iterator position, const T& x) {
+    T x_copy = x;
+    base_ptr p = position.node;
+    size_type i = position.index;
+    if (i == 0 && p->prev != node() && ((link_type)p->prev)->count < N) {
+        p = p->prev;  //前一个节点有空位，直接接在它的尾部
+        i = ((link_type)p)->count;
+    } else if (p == node()) {
+        p = create_node(node());
+    } else if (((link_type)p)->count == N) {  //节点已满，对半拆开
+        link_type q = split_node((link_type)p, N / 2);
+        if (i > N / 2) {
+            p = q;
+            i -= N / 2;
+        }
+    }
+
+    link_type n = (link_type)p;
+    T* e = n->elems();
+    if (i == n->count)
+        construct(e + i, x_copy);
+    else {
+        construct(e + n->count, e[n->count - 1]);
+        std::copy_backward(e + i, e + n->count - 1, e + n->count);
+        e[i] = x_copy;
+    }
+    ++n->count;
+    ++length;
+    return iterator(p, i);
+}
+
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::erase(iterator position) {
+    link_type n = (link_type)position.node;
+    size_type i = position.index;
+    T* e = n->elems();
+    std::copy(e + i + 1, e + n->count, e + i);
+    destroy(e + n->count - 1);
+    --n->count;
+    --length;
+
+    base_ptr next = n->next;
+    if (n->count == 0) {
+        destroy_node(n);
+        return iterator(next, 0);
+    }
+    if (next != node() && n->count + ((link_type)next)->count <= N / 2) {
+        link_type m = (link_type)next;  //两个节点都很空，合并以保持密度
+        TinySTL::uninitialized_copy(m->elems(), m->elems() + m->count,
+                                    e + n->count);
+        destroy(m->elems(), m->elems() + m->count);
+        n->count += m->count;
+        destroy_node(m);
+    }
+    if (i == n->count) return iterator(n->next, 0);
+    return iterator(n, i);
+}
+
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::erase(iterator first, iterator last) {
+    size_type n = 0;  //合并节点会使last失效，先数出个数
+    for (iterator i = first; i != last; ++i) ++n;
+    for (; n > 0; --n) first = erase(first);
+    return first;
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::clear() {
+    base_ptr cur = sentinel.next;
+    while (cur != node()) {
+        link_type tmp = (link_type)cur;
+        cur = cur->next;
+        destroy(tmp->elems(), tmp->elems() + tmp->count);
+        list_node_allocator::deallocate(tmp);
+    }
+    empty_initialize();
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::swap(unrolled_list<T, N, Alloc>& x) {
+    unrolled_list<T, N, Alloc> tmp;
+    tmp.splice(tmp.end(), *this);
+    splice(end(), x);
+    x.splice(x.end(), tmp);
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::splice(iterator position,
+                                        unrolled_list<T, N, Alloc>& x,
+                                        iterator first, iterator last) {
+    if (first == last) return;
+    base_ptr l = x.cut(last);  //先切last，切first不会影响它
+    base_ptr f = x.cut(first);
+    base_ptr pos = cut(position);
+
+    size_type n = 0;
+    for (base_ptr p = f; p != l; p = p->next) n += ((link_type)p)->count;
+
+    base_ptr tail = l->prev;
+    f->prev->next = l;  //从x中摘下[f, l)
+    l->prev = f->prev;
+    f->prev = pos->prev;  //接到pos前
+    tail->next = pos;
+    pos->prev->next = f;
+    pos->prev = tail;
+
+    length += n;
+    x.length -= n;
+}
+
+}  // namespace TinySTL
+
+#endif
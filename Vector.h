@@ -1,6 +1,8 @@
 #ifndef VECTOR_H__
 #define VECTOR_H__
 
+#include <algorithm>
+#include <utility>
 #include "Alloc.h"
 #include "Construct.h"
 #include "Uninitialized.h"
@@ -14,6 +16,7 @@ class vector {
     typedef value_type* pointer;
     typedef value_type* iterator;
     typedef value_type& reference;
+    typedef const value_type& const_reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
 
@@ -36,7 +39,18 @@ class vector {
     }
     iterator allocate_and_fill(size_type n, const T& x) {
         iterator result = data_allocator::allocate(n);
-        uninitialized_fill_n(result, n, x);
+        TinySTL::uninitialized_fill_n(result, n, x);
+        return result;
+    }
+    iterator allocate_and_copy(size_type n, iterator first, iterator last) {
+        iterator result = data_allocator::allocate(n);
+        try {
+            TinySTL::uninitialized_copy(first, last, result);
+        }
+        catch (...) {
+            data_allocator::deallocate(result, n);
+            throw;
+        }
         return result;
     }
 
@@ -48,6 +62,7 @@ class vector {
     bool empty() const { return begin() == end(); }
     //重载了operator[]，使其可以用类似于数组索引的方式访问元素: vec[i]
     reference operator[](size_type n) { return *(begin() + n); }
+    const_reference operator[](size_type n) const { return *(begin() + n); }
 
     vector() : start(0), finish(0), end_of_storage(0) {}
     vector(size_type n, const T& value) { fill_initialize(n, value); }
@@ -57,10 +72,27 @@ class vector {
         //会调用类型T的默认构造函数: T()
         fill_initialize(n, T());
     }
+    vector(const vector& x) {
+        start = allocate_and_copy(x.size(), x.begin(), x.end());
+        finish = start + x.size();
+        end_of_storage = finish;
+    }
     ~vector() {
         destroy(start, finish);
         deallocate();
     }
+    vector& operator=(const vector& x) {
+        if (this != &x) {
+            vector tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    void swap(vector& x) {
+        std::swap(start, x.start);
+        std::swap(finish, x.finish);
+        std::swap(end_of_storage, x.end_of_storage);
+    }
     
     reference front() { return *begin(); }
     reference back() { return *(end() - 1); }
@@ -92,14 +124,14 @@ class vector {
         //如果移除的不是最后一个元素
         if (position + 1 != end())
             //被移除元素之后的所有元素前移一个位置
-            copy(position + 1, finish, position);
+            std::copy(position + 1, finish, position);
         --finish;
         destroy(finish);
         return position;
     }
     //移除半开半闭区间[first, last)之间的所有元素，last指向的元素不被移除
     iterator erase(iterator first, iterator last) {
-        iterator i = copy(last, finish, first);
+        iterator i = std::copy(last, finish, first);
         //如果区间内元素的析构函数是trivial的，则什么也不做
         //如果区间内元素的析构函数是non-trivial的，则依序调用其析构函数
         destroy(i, finish);
@@ -116,6 +148,18 @@ class vector {
     //清空容器内的所有元素
     //导致size()为0，但是capacity()不变
     void clear() { erase(begin(), end()); }
+    //预先配置至少能容纳n个元素的空间，之后n个以内的push_back不再搬移
+    void reserve(size_type n) {
+        if (capacity() >= n) return;
+        iterator new_start = data_allocator::allocate(n);
+        iterator new_finish =
+            TinySTL::uninitialized_copy(start, finish, new_start);
+        destroy(start, finish);
+        deallocate();
+        start = new_start;
+        finish = new_finish;
+        end_of_storage = new_start + n;
+    }
 };
 
 template <class T, class Alloc>
@@ -131,10 +175,10 @@ void vector<T, Alloc>::insert_aux(iterator position, const T& x) {
         const size_type len = old_size != 0 ? 2 * old_size : 1;  //扩大为两倍
         iterator new_start = data_allocator::allocate(len);
         iterator new_finish = new_start;
-        new_finish = uninitialized_copy(start, position, new_start);
+        new_finish = TinySTL::uninitialized_copy(start, position, new_start);
         construct(new_finish, x);
         ++new_finish;
-        new_finish = uninitialized_copy(position, finish, new_finish);
+        new_finish = TinySTL::uninitialized_copy(position, finish, new_finish);
 
         destroy(begin(), end());
         deallocate();
@@ -153,25 +197,27 @@ void vector<T, Alloc>::insert(vector::iterator position, size_type n,
             const size_type elems_after = finish - position;
             iterator old_finish = finish;
             if (elems_after > n) {
-                uninitialized_copy(finish - n, finish, finish);
+                TinySTL::uninitialized_copy(finish - n, finish, finish);
                 finish += n;
-                copy_backward(position, old_finish - n, old_finish);
-                fill(position, position + n, x_copy);
+                std::copy_backward(position, old_finish - n, old_finish);
+                std::fill(position, position + n, x_copy);
             } else {
-                uninitialized_fill_n(finish, n - elems_after, x_copy);
+                TinySTL::uninitialized_fill_n(finish, n - elems_after, x_copy);
                 finish += n - elems_after;
-                uninitialized_copy(position, old_finish, finish);
+                TinySTL::uninitialized_copy(position, old_finish, finish);
                 finish += elems_after;
-                fill(position, old_finish, x_copy);
+                std::fill(position, old_finish, x_copy);
             }
         } else {
             const size_type old_size = size();
             const size_type len = old_size + std::max(old_size, n);
             iterator new_start = data_allocator::allocate(len);
             iterator new_finish = new_start;
-            new_finish = uninitialized_copy(start, position, new_start);
-            new_finish = uninitialized_fill_n(new_finish, n, x);
-            new_finish = uninitialized_copy(position, finish, new_finish);
+            new_finish =
+                TinySTL::uninitialized_copy(start, position, new_start);
+            new_finish = TinySTL::uninitialized_fill_n(new_finish, n, x);
+            new_finish =
+                TinySTL::uninitialized_copy(position, finish, new_finish);
       
             destroy(start, finish);
             deallocate();
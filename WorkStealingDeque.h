@@ -0,0 +1,152 @@
+#ifndef WORKSTEALINGDEQUE_H__
+#define WORKSTEALINGDEQUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include "Alloc.h"
+
+namespace TinySTL {
+
+//环形数组，下标对容量取模，容量是2的幂
+template <class T>
+struct __ws_array {
+    ptrdiff_t mask;
+    std::atomic<T>* slots;
+    __ws_array* retired;  //被它替换掉的旧数组，析构时一起释放
+
+    T get(ptrdiff_t i) const {
+        return slots[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(ptrdiff_t i, const T& x) {
+        slots[i & mask].store(x, std::memory_order_relaxed);
+    }
+};
+
+// Chase-Lev工作窃取双端队列
+//拥有者线程在bottom端push/pop（后进先出），其他线程在top端steal（先进先出）
+//只有bottom == top + 1时拥有者和窃取者才会争同一个元素，用CAS top决出胜负
+//数组满时拥有者换一个两倍大的数组，旧数组可能还有窃取者在读，留到析构时释放
+//元素以std::atomic<T>存放，T须可平凡复制，通常是任务指针
+//扩容在push中进行，可能和其他线程的分配并发，默认用线程安全的malloc_alloc
+template <class T, class Alloc = malloc_alloc>
+class work_stealing_deque {
+    //槽位按位读写，从不构造和析构元素
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "work_stealing_deque requires trivially copyable T");
+
+   public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+   protected:
+    typedef __ws_array<T> array_type;
+    typedef simple_alloc<array_type, Alloc> array_allocator;
+    typedef simple_alloc<std::atomic<T>, Alloc> slot_allocator;
+    enum { cache_line_size = 64 };
+
+    alignas(cache_line_size) std::atomic<ptrdiff_t> top;  //窃取者竞争
+    alignas(cache_line_size) std::atomic<ptrdiff_t> bottom;  //只由拥有者写
+    std::atomic<array_type*> array;
+
+    static array_type* create_array(size_type capacity) {
+        array_type* a = array_allocator::allocate();
+        a->mask = ptrdiff_t(capacity) - 1;
+        a->slots = slot_allocator::allocate(capacity);
+        a->retired = 0;
+        return a;
+    }
+    static void destroy_array(array_type* a) {
+        slot_allocator::deallocate(a->slots, size_type(a->mask) + 1);
+        array_allocator::deallocate(a);
+    }
+
+    //把[t, b)搬到两倍大的新数组，旧数组挂在新数组上
+    array_type* grow(array_type* a, ptrdiff_t t, ptrdiff_t b) {
+        array_type* n = create_array(2 * (size_type(a->mask) + 1));
+        for (ptrdiff_t i = t; i != b; ++i) n->put(i, a->get(i));
+        n->retired = a;
+        array.store(n, std::memory_order_release);
+        return n;
+    }
+
+   public:
+    explicit work_stealing_deque(size_type capacity = 64) : top(0), bottom(0) {
+        size_type cap = 2;
+        while (cap < capacity) cap <<= 1;
+        array.store(create_array(cap), std::memory_order_relaxed);
+    }
+    //析构时不能有其他线程在使用队列
+    ~work_stealing_deque() {
+        array_type* a = array.load(std::memory_order_relaxed);
+        while (a) {
+            array_type* next = a->retired;
+            destroy_array(a);
+            a = next;
+        }
+    }
+
+   private:
+    work_stealing_deque(const work_stealing_deque&);
+    work_stealing_deque& operator=(const work_stealing_deque&);
+
+   public:
+    size_type capacity() const {
+        return size_type(array.load(std::memory_order_relaxed)->mask) + 1;
+    }
+    //其他线程可能同时在修改，结果只是近似值
+    size_type size() const {
+        ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+        ptrdiff_t t = top.load(std::memory_order_relaxed);
+        return b > t ? size_type(b - t) : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    //只能由拥有者线程调用
+    void push(const value_type& x) {
+        ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+        ptrdiff_t t = top.load(std::memory_order_acquire);
+        array_type* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->mask) a = grow(a, t, b);
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    //只能由拥有者线程调用，取最后push的元素，空时返回false
+    bool pop(value_type& x) {
+        ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+        array_type* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {  //已经空了
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        x = a->get(b);
+        if (t < b) return true;
+        //只剩一个元素，和窃取者竞争
+        bool won = top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    //任何线程都可以调用，取最早push的元素
+    //队列空或者和其他线程竞争失败时返回false，调用者可以重试或换一个队列
+    bool steal(value_type& x) {
+        ptrdiff_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        array_type* a = array.load(std::memory_order_acquire);
+        x = a->get(t);
+        return top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+};
+
+}  // namespace TinySTL
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef BENCH_H__
+#define BENCH_H__
+
+#include <chrono>
+#include <cstdio>
+
+//基准测试共用的计时工具
+class bench_timer {
+   public:
+    bench_timer() : start(clock::now()) {}
+    void reset() { start = clock::now(); }
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(clock::now() - start)
+            .count();
+    }
+
+   private:
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start;
+};
+
+//防止编译器把只读不写的结果优化掉
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+inline void report(const char* name, const char* container, double ms) {
+    printf("%-28s %-20s %10.2f ms\n", name, container, ms);
+}
+
+#endif
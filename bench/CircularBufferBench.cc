@@ -0,0 +1,81 @@
+#include "../CircularBuffer.h"
+#include "../Deque.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kItems = 50000000;
+const size_t kWindow = 1000;
+const long kSumEvery = 10000;  //每进来这么多个元素对整个窗口求一次和
+
+void bench_deque_window() {
+    deque<long> w;
+    long sum = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; ++i) {
+        w.push_back(i);
+        if (w.size() > kWindow) w.pop_front();
+        if (i % kSumEvery == 0)
+            for (deque<long>::iterator it = w.begin(); it != w.end(); ++it)
+                sum += *it;
+    }
+    do_not_optimize(sum);
+    report("sliding window 50M/1000", "deque", t.elapsed_ms());
+}
+
+void bench_circular_buffer_window() {
+    circular_buffer<long> w(kWindow, true);
+    long sum = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; ++i) {
+        w.push_back(i);
+        if (i % kSumEvery == 0) {  //两段连续区间，编译器可以向量化
+            circular_buffer<long>::array_range one = w.array_one(),
+                                               two = w.array_two();
+            for (size_t k = 0; k < one.second; ++k) sum += one.first[k];
+            for (size_t k = 0; k < two.second; ++k) sum += two.first[k];
+        }
+    }
+    do_not_optimize(sum);
+    report("sliding window 50M/1000", "circular_buffer", t.elapsed_ms());
+}
+
+void bench_deque_fifo() {
+    deque<long> q;
+    long sum = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; ++i) {
+        q.push_back(i);
+        if (q.size() == kWindow)
+            while (!q.empty()) {
+                sum += q.front();
+                q.pop_front();
+            }
+    }
+    do_not_optimize(sum);
+    report("fill/drain 50M/1000", "deque", t.elapsed_ms());
+}
+
+void bench_circular_buffer_fifo() {
+    circular_buffer<long> q(kWindow);
+    long sum = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; ++i) {
+        q.push_back(i);
+        if (q.full())
+            while (!q.empty()) {
+                sum += q.front();
+                q.pop_front();
+            }
+    }
+    do_not_optimize(sum);
+    report("fill/drain 50M/1000", "circular_buffer", t.elapsed_ms());
+}
+
+int main() {
+    bench_deque_window();
+    bench_circular_buffer_window();
+    bench_deque_fifo();
+    bench_circular_buffer_fifo();
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <map>
+#include <mutex>
+#include <thread>
+#include "../ConcurrentMap.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kOps = 4000000;
+const int kKeys = 1 << 16;
+const int kMaxThreads = 64;
+
+inline unsigned xorshift(unsigned& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+//90%查找，5%插入，5%删除，键均匀分布
+//TinySTL::map还不能编译，加锁的基准用std::map
+void bench_locked_map(int threads) {
+    std::map<int, int> m;
+    std::mutex lock;
+    for (int k = 0; k < kKeys; k += 2) m[k] = k;
+    std::thread workers[kMaxThreads];
+    bench_timer t;
+    for (int i = 0; i < threads; ++i)
+        workers[i] = std::thread([&m, &lock, threads, i] {
+            unsigned s = i * 7919 + 1;
+            long hits = 0;
+            for (long n = 0; n < kOps / threads; ++n) {
+                unsigned r = xorshift(s), op = r % 100;
+                int k = (r >> 8) % kKeys;
+                std::lock_guard<std::mutex> guard(lock);
+                if (op < 90)
+                    hits += m.find(k) != m.end();
+                else if (op < 95)
+                    m.insert(std::pair<const int, int>(k, k));
+                else
+                    m.erase(k);
+            }
+            do_not_optimize(hits);
+        });
+    for (int i = 0; i < threads; ++i) workers[i].join();
+    char name[32];
+    snprintf(name, sizeof(name), "90/10 4M ops %d threads", threads);
+    report(name, "mutex+std::map", t.elapsed_ms());
+}
+
+void bench_concurrent_map(int threads) {
+    concurrent_map<int, int> m;
+    for (int k = 0; k < kKeys; k += 2) m.insert(std::pair<const int, int>(k, k));
+    std::thread workers[kMaxThreads];
+    bench_timer t;
+    for (int i = 0; i < threads; ++i)
+        workers[i] = std::thread([&m, threads, i] {
+            unsigned s = i * 7919 + 1;
+            long hits = 0;
+            for (long n = 0; n < kOps / threads; ++n) {
+                unsigned r = xorshift(s), op = r % 100;
+                int k = (r >> 8) % kKeys;
+                if (op < 90)
+                    hits += m.find(k) != m.end();
+                else if (op < 95)
+                    m.insert(std::pair<const int, int>(k, k));
+                else
+                    m.erase(k);
+            }
+            do_not_optimize(hits);
+        });
+    for (int i = 0; i < threads; ++i) workers[i].join();
+    char name[32];
+    snprintf(name, sizeof(name), "90/10 4M ops %d threads", threads);
+    report(name, "concurrent_map", t.elapsed_ms());
+}
+
+//区间遍历：每次从随机键开始读64个元素
+void bench_range_scan(int threads) {
+    concurrent_map<int, int> m;
+    for (int k = 0; k < kKeys; ++k) m.insert(std::pair<const int, int>(k, k));
+    std::thread workers[kMaxThreads];
+    bench_timer t;
+    for (int i = 0; i < threads; ++i)
+        workers[i] = std::thread([&m, threads, i] {
+            unsigned s = i * 7919 + 1;
+            long sum = 0;
+            for (long n = 0; n < kOps / 64 / threads; ++n) {
+                concurrent_map<int, int>::const_iterator it =
+                    m.lower_bound(xorshift(s) % kKeys);
+                for (int c = 0; c < 64 && it != m.end(); ++c, ++it)
+                    sum += it->second;
+            }
+            do_not_optimize(sum);
+        });
+    for (int i = 0; i < threads; ++i) workers[i].join();
+    char name[32];
+    snprintf(name, sizeof(name), "scan 64 x 62.5K %d threads", threads);
+    report(name, "concurrent_map", t.elapsed_ms());
+}
+
+int main() {
+    for (int threads = 1; threads <= kMaxThreads; threads *= 2) {
+        bench_locked_map(threads);
+        bench_concurrent_map(threads);
+    }
+    for (int threads = 1; threads <= kMaxThreads; threads *= 4)
+        bench_range_scan(threads);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "../Deque.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElems = 1 << 20;
+const int kRepeat = 50;
+
+struct Sum {
+    long total;
+    Sum() : total(0) {}
+    void operator()(int x) { total += x; }
+};
+
+typedef deque<int>::iterator iter;
+
+//逐个元素走迭代器的通用写法，作为对照
+namespace naive {
+iter copy(iter first, iter last, iter result) {
+    for (; first != last; ++first, ++result) *result = *first;
+    return result;
+}
+iter copy_backward(iter first, iter last, iter result) {
+    while (first != last) *--result = *--last;
+    return result;
+}
+void fill(iter first, iter last, int value) {
+    for (; first != last; ++first) *first = value;
+}
+iter find(iter first, iter last, int value) {
+    while (first != last && *first != value) ++first;
+    return first;
+}
+Sum for_each(iter first, iter last, Sum f) {
+    for (; first != last; ++first) f(*first);
+    return f;
+}
+bool equal(iter first1, iter last1, iter first2) {
+    for (; first1 != last1; ++first1, ++first2)
+        if (*first1 != *first2) return false;
+    return true;
+}
+}  // namespace naive
+
+void bench_algorithms(deque<int>& a, deque<int>& b) {
+    bench_timer t;
+    for (int r = 0; r < kRepeat; ++r) naive::copy(a.begin(), a.end(), b.begin());
+    report("copy 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r) copy(a.begin(), a.end(), b.begin());
+    report("copy 50 x 1M", "segmented", t.elapsed_ms());
+
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        naive::copy_backward(a.begin(), a.end() - 1, a.end());
+    report("copy_backward 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        copy_backward(a.begin(), a.end() - 1, a.end());
+    report("copy_backward 50 x 1M", "segmented", t.elapsed_ms());
+
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r) naive::fill(b.begin(), b.end(), r);
+    report("fill 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r) fill(b.begin(), b.end(), r);
+    report("fill 50 x 1M", "segmented", t.elapsed_ms());
+
+    long hits = 0;
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        hits += naive::find(a.begin(), a.end(), -1) == a.end();
+    report("find (miss) 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        hits += find(a.begin(), a.end(), -1) == a.end();
+    report("find (miss) 50 x 1M", "segmented", t.elapsed_ms());
+
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        hits += naive::for_each(a.begin(), a.end(), Sum()).total;
+    report("for_each 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        hits += for_each(a.begin(), a.end(), Sum()).total;
+    report("for_each 50 x 1M", "segmented", t.elapsed_ms());
+
+    copy(a.begin(), a.end(), b.begin());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r)
+        hits += naive::equal(a.begin(), a.end(), b.begin());
+    report("equal 50 x 1M", "per-element", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < kRepeat; ++r) hits += equal(a.begin(), a.end(), b.begin());
+    report("equal 50 x 1M", "segmented", t.elapsed_ms());
+    do_not_optimize(hits);
+}
+
+//deque自身在中间插入和删除时搬移元素
+void bench_members(deque<int>& a) {
+    bench_timer t;
+    for (int r = 0; r < 2000; ++r) a.insert(a.begin() + kElems / 3, r);
+    report("insert at 1/3, 2000x", "deque", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < 2000; ++r) a.erase(a.begin() + kElems / 3);
+    report("erase at 1/3, 2000x", "deque", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < 200; ++r) a.insert(a.begin() + kElems / 3, 64, r);
+    report("insert 64 at 1/3, 200x", "deque", t.elapsed_ms());
+    t.reset();
+    for (int r = 0; r < 200; ++r)
+        a.erase(a.begin() + kElems / 3, a.begin() + kElems / 3 + 64);
+    report("erase 64 at 1/3, 200x", "deque", t.elapsed_ms());
+}
+
+int main() {
+    deque<int> a, b;
+    for (int i = 0; i < kElems; ++i) {
+        a.push_back(i);
+        b.push_back(0);
+    }
+    b.pop_front();  //让两边的缓冲区边界错开
+    b.push_back(0);
+    bench_algorithms(a, b);
+    bench_members(a);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include "../Deque.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElems = 1 << 20;
+const int kLookups = 20000000;
+
+struct Vec3 {  // 12字节，512 / 12不是2的幂
+    int x, y, z;
+};
+
+inline long value_of(int v) { return v; }
+inline long value_of(const Vec3& v) { return v.x; }
+inline void make_value(int& v, int i) { v = i; }
+inline void make_value(Vec3& v, int i) { v.x = v.y = v.z = i; }
+
+template <class Deque>
+void run(const char* container, const int* idx) {
+    typedef typename Deque::value_type value_type;
+    Deque d;
+    value_type v;
+    for (int i = 0; i < kElems; ++i) {
+        make_value(v, i);
+        d.push_back(v);
+    }
+    for (int i = 0; i < kElems / 4; ++i) d.pop_front();  // start不在缓冲区开头
+    long sum = 0;
+
+    bench_timer t;
+    for (int i = 0; i < kLookups; ++i) sum += value_of(d[idx[i]]);
+    report("random operator[] 20M", container, t.elapsed_ms());
+
+    t.reset();
+    for (int r = 0; r < 20; ++r)
+        for (typename Deque::iterator it = d.begin(); it != d.end(); ++it)
+            sum += value_of(*it);
+    report("iterate 20 x 786K", container, t.elapsed_ms());
+
+    t.reset();
+    typename Deque::iterator it = d.begin();
+    for (int i = 0; i < kLookups; ++i) {
+        typename Deque::iterator p = it + idx[i];
+        sum += value_of(*p) + (p - it);
+    }
+    report("iterator + and - 20M", container, t.elapsed_ms());
+    do_not_optimize(sum);
+}
+
+int main() {
+    int* idx = new int[kLookups];
+    for (int i = 0; i < kLookups; ++i) idx[i] = rand() % (kElems * 3 / 4);
+    run<deque<int> >("deque<int>", idx);
+    run<deque<int, alloc, 100> >("deque<int,100>", idx);
+    run<deque<Vec3> >("deque<Vec3>", idx);
+    run<deque<Vec3, alloc, 42> >("deque<Vec3,42>", idx);
+    delete[] idx;
+    return 0;
+}
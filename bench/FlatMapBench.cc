@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+#include "../FlatMap.h"
+#include "../Map.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+
+//统计申请的字节数，不含malloc自己每块的额外开销
+struct counting_alloc {
+    static size_t bytes;
+    static void* allocate(size_t n) {
+        bytes += n;
+        return malloc_alloc::allocate(n);
+    }
+    static void deallocate(void* p, size_t n) {
+        bytes -= n;
+        malloc_alloc::deallocate(p, n);
+    }
+};
+size_t counting_alloc::bytes = 0;
+
+typedef map<int, int, std::less<int>, counting_alloc> counted_map;
+typedef flat_map<int, int, std::less<int>, counting_alloc> counted_flat_map;
+typedef std::vector<std::pair<int, int> > snapshot;
+
+template <class Map>
+void bench_lookup(const Map& m, const std::vector<int>& probes,
+                  const char* name) {
+    long sum = 0;
+    bench_timer t;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        typename Map::const_iterator it = m.find(probes[i]);
+        if (it != m.end()) sum += it->second;
+    }
+    do_not_optimize(sum);
+    report("find 1M random, 50% hit", name, t.elapsed_ms());
+}
+
+//同一个数组上用有分支的std::lower_bound查找，对比无分支二分
+void bench_std_lower_bound(const counted_flat_map& m,
+                           const std::vector<int>& probes) {
+    struct key_less {
+        bool operator()(const std::pair<int, int>& x, int k) const {
+            return x.first < k;
+        }
+    };
+    long sum = 0;
+    bench_timer t;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        const std::pair<int, int>* it =
+            std::lower_bound(m.begin(), m.end(), probes[i], key_less());
+        if (it != m.end() && it->first == probes[i]) sum += it->second;
+    }
+    do_not_optimize(sum);
+    report("find 1M random, 50% hit", "std::lower_bound", t.elapsed_ms());
+}
+
+int main() {
+    snapshot s;
+    for (int i = 0; i < kElements; ++i) s.push_back(std::make_pair(i * 2, i));
+    std::random_shuffle(s.begin(), s.end());
+    std::vector<int> probes;
+    for (int i = 0; i < kElements; ++i) probes.push_back(s[i].first + i % 2);
+    std::random_shuffle(probes.begin(), probes.end());
+
+    char bytes[32];
+    bench_timer t;
+    counted_map m(s.begin(), s.end());
+    report("build 1M shuffled", "map", t.elapsed_ms());
+    snprintf(bytes, sizeof(bytes), "%.1f MB map", counting_alloc::bytes / 1e6);
+    counting_alloc::bytes = 0;
+
+    t.reset();
+    counted_flat_map f(s.begin(), s.end());
+    report("build 1M shuffled", "flat_map", t.elapsed_ms());
+    printf("memory: %s, %.1f MB flat_map\n", bytes,
+           counting_alloc::bytes / 1e6);
+
+    bench_lookup(m, probes, "map");
+    bench_lookup(f, probes, "flat_map");
+    bench_std_lower_bound(f, probes);
+
+    //1000个一批插入：归并 vs 逐个插入
+    snapshot extra;
+    for (int i = 0; i < 1000; ++i)
+        extra.push_back(std::make_pair(i * 2001 + 1, i));
+    counted_flat_map g(f);
+    t.reset();
+    f.insert(extra.begin(), extra.end());
+    report("insert 1000 into 1M", "flat_map batch", t.elapsed_ms());
+    t.reset();
+    for (size_t i = 0; i < extra.size(); ++i) g.insert(extra[i]);
+    report("insert 1000 into 1M", "flat_map one by one", t.elapsed_ms());
+    return 0;
+}
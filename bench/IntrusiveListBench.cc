@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include "../IntrusiveList.h"
+#include "../List.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kObjects = 1000000;
+
+//连接对象：intrusive_list用钩子，list<Connection*>另存迭代器以便O(1)删除
+struct Connection {
+    int fd;
+    list_hook hook;
+    list<Connection*>::iterator pos;
+};
+
+typedef intrusive_list<Connection, &Connection::hook> conn_ilist;
+typedef list<Connection*> conn_plist;
+
+void bench_intrusive(Connection* conns, const int* order) {
+    conn_ilist l;
+    bench_timer t;
+    for (int i = 0; i < kObjects; ++i) l.push_back(conns[i]);
+    report("link 1M", "intrusive_list", t.elapsed_ms());
+
+    t.reset();
+    long long sum = 0;
+    for (conn_ilist::iterator it = l.begin(); it != l.end(); ++it)
+        sum += it->fd;
+    do_not_optimize(sum);
+    report("iterate 1M", "intrusive_list", t.elapsed_ms());
+
+    t.reset();  //按随机顺序把对象挪到尾部，类似LRU/定时器刷新
+    for (int i = 0; i < kObjects; ++i) {
+        Connection& c = conns[order[i]];
+        l.remove(c);
+        l.push_back(c);
+    }
+    report("touch (unlink+relink) 1M", "intrusive_list", t.elapsed_ms());
+
+    t.reset();
+    l.clear();
+    report("clear 1M", "intrusive_list", t.elapsed_ms());
+}
+
+void bench_pointer_list(Connection* conns, const int* order) {
+    conn_plist l;
+    bench_timer t;
+    for (int i = 0; i < kObjects; ++i) {
+        l.push_back(&conns[i]);
+        conns[i].pos = --l.end();
+    }
+    report("link 1M", "list<T*>", t.elapsed_ms());
+
+    t.reset();
+    long long sum = 0;
+    for (conn_plist::iterator it = l.begin(); it != l.end(); ++it)
+        sum += (*it)->fd;
+    do_not_optimize(sum);
+    report("iterate 1M", "list<T*>", t.elapsed_ms());
+
+    t.reset();
+    for (int i = 0; i < kObjects; ++i) {
+        Connection& c = conns[order[i]];
+        l.erase(c.pos);
+        l.push_back(&c);
+        c.pos = --l.end();
+    }
+    report("touch (unlink+relink) 1M", "list<T*>", t.elapsed_ms());
+
+    t.reset();
+    l.clear();
+    report("clear 1M", "list<T*>", t.elapsed_ms());
+}
+
+int main() {
+    Connection* conns = new Connection[kObjects];
+    int* order = new int[kObjects];
+    for (int i = 0; i < kObjects; ++i) {
+        conns[i].fd = i;
+        order[i] = rand() % kObjects;
+    }
+    bench_pointer_list(conns, order);
+    bench_intrusive(conns, order);
+    delete[] order;
+    delete[] conns;
+    return 0;
+}
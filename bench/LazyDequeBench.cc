@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include "../Queue.h"
+#include "../Stack.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kContainers = 2000000;
+const int kUsedEvery = 16;  //每16个容器只有1个被用到
+
+//统计deque向堆要了多少内存
+struct bench_counting_alloc {
+    static size_t bytes;
+    static size_t calls;
+    static void* allocate(size_t n) {
+        bytes += n;
+        ++calls;
+        return malloc(n);
+    }
+    static void deallocate(void* p, size_t) { free(p); }
+};
+size_t bench_counting_alloc::bytes = 0;
+size_t bench_counting_alloc::calls = 0;
+
+typedef deque<int, bench_counting_alloc> counted_deque;
+
+//构造kContainers个容器，少数push/pop一次，再全部析构
+template <class Container>
+void bench_mostly_empty(const char* name) {
+    bench_counting_alloc::bytes = 0;
+    bench_counting_alloc::calls = 0;
+    bench_timer t;
+    Container* c = new Container[kContainers];
+    for (int i = 0; i < kContainers; i += kUsedEvery) {
+        c[i].push(i);
+        c[i].pop();
+    }
+    do_not_optimize(c);
+    delete[] c;
+    report("2M mostly-empty", name, t.elapsed_ms());
+    printf("%-28s %-20s %10.1f MB in %zu allocations\n", "", "",
+           bench_counting_alloc::bytes / 1048576.0, bench_counting_alloc::calls);
+}
+
+int main() {
+    bench_mostly_empty<stack<int, counted_deque> >("stack<int>");
+    bench_mostly_empty<queue<int, counted_deque> >("queue<int>");
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <cstdlib>
+#include <string>
+#include "../List.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+//暴露两种排序路径，便于分别计时
+template <class T>
+struct bench_list : public list<T> {
+    void sort_in_place() { list<T>::sort_in_place(); }
+    void sort_by_buffer() { list<T>::sort_by_buffer(); }
+};
+
+inline void make_value(int& v, int r) { v = r; }
+inline void make_value(double& v, int r) { v = r * 0.5; }
+inline void make_value(std::string& v, int r) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "k%08d", r);
+    v = buf;
+}
+
+//先排一次把节点在内存中的顺序打乱，再填入新的随机值后计时
+template <class T>
+void refill_random(bench_list<T>& l) {
+    for (typename list<T>::iterator it = l.begin(); it != l.end(); ++it)
+        make_value(*it, rand());
+}
+
+template <class T>
+void bench_sort(const char* type, size_t n) {
+    double in_place = 0, by_buffer = 0;
+    const int rounds = n <= 100000 ? 10 : 2;
+    bench_list<T> l;
+    T v;
+    for (size_t i = 0; i < n; ++i) {
+        make_value(v, rand());
+        l.push_back(v);
+    }
+    l.sort_in_place();
+    for (int r = 0; r < rounds; ++r) {
+        refill_random(l);
+        bench_timer t;
+        l.sort_in_place();
+        in_place += t.elapsed_ms();
+
+        refill_random(l);
+        t.reset();
+        l.sort_by_buffer();
+        by_buffer += t.elapsed_ms();
+    }
+    printf("%-8s n=%-9zu in-place %10.2f ms   buffer %10.2f ms\n", type, n,
+           in_place / rounds, by_buffer / rounds);
+}
+
+int main() {
+    size_t sizes[] = {1000, 4096, 10000, 100000, 1000000};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        bench_sort<int>("int", sizes[i]);
+        bench_sort<double>("double", sizes[i]);
+        bench_sort<std::string>("string", sizes[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+#include "../Map.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+
+typedef std::vector<std::pair<int, int> > snapshot;
+//默认的内存池本身很慢，用malloc_alloc单独比较建树的开销
+typedef map<int, int, std::less<int>, malloc_alloc> malloc_map;
+
+template <class Map>
+void bench_one_by_one(const snapshot& s, const char* name) {
+    bench_timer t;
+    Map m;
+    for (size_t i = 0; i < s.size(); ++i) m.insert(s[i]);
+    report("build 1M sorted", name, t.elapsed_ms());
+    do_not_optimize(m);
+}
+
+template <class Map>
+void bench_range_ctor(const snapshot& s, const char* what, const char* name) {
+    bench_timer t;
+    Map m(s.begin(), s.end());
+    report(what, name, t.elapsed_ms());
+    do_not_optimize(m);
+}
+
+//建好之后每个键查找一次
+template <class Map>
+void bench_lookup(const snapshot& s, const char* name) {
+    Map m(s.begin(), s.end());
+    long sum = 0;
+    bench_timer t;
+    for (size_t i = 0; i < s.size(); ++i) sum += m.find(s[i].first)->second;
+    do_not_optimize(sum);
+    report("find 1M after build", name, t.elapsed_ms());
+}
+
+int main() {
+    snapshot s;
+    for (int i = 0; i < kElements; ++i) s.push_back(std::make_pair(i * 2, i));
+    snapshot shuffled(s);
+    std::random_shuffle(shuffled.begin(), shuffled.end());
+
+    bench_one_by_one<malloc_map>(s, "insert loop");
+    bench_range_ctor<malloc_map>(s, "build 1M sorted", "range ctor");
+    bench_range_ctor<std::map<int, int> >(s, "build 1M sorted",
+                                          "std::map range ctor");
+    bench_range_ctor<malloc_map>(shuffled, "build 1M shuffled", "range ctor");
+    bench_lookup<malloc_map>(s, "range ctor");
+    bench_range_ctor<map<int, int> >(s, "build 1M sorted",
+                                     "range ctor, alloc");
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../Queue.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kPairs = 2000000;  //所有线程合计的push+pop次数
+const int kSampleEvery = 8;   //每8次操作记录一次耗时
+
+//互斥锁保护的queue，作为对照
+class locked_queue {
+   public:
+    void push(long x) {
+        std::lock_guard<std::mutex> lock(m);
+        q.push(x);
+    }
+    void pop(long& x) {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (!q.empty()) {
+                    x = q.front();
+                    q.pop();
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+   private:
+    std::mutex m;
+    queue<long> q;
+};
+
+//每个线程交替push和pop，记录抽样的单次操作耗时(ns)
+template <class Queue>
+void worker(Queue& q, long pairs, std::vector<double>& samples) {
+    typedef std::chrono::steady_clock clock;
+    long x, sum = 0;
+    for (long i = 0; i < pairs; ++i) {
+        if (i % kSampleEvery == 0) {
+            clock::time_point t0 = clock::now();
+            q.push(i);
+            clock::time_point t1 = clock::now();
+            q.pop(x);
+            clock::time_point t2 = clock::now();
+            samples.push_back(
+                std::chrono::duration<double, std::nano>(t1 - t0).count());
+            samples.push_back(
+                std::chrono::duration<double, std::nano>(t2 - t1).count());
+        } else {
+            q.push(i);
+            q.pop(x);
+        }
+        sum += x;
+    }
+    do_not_optimize(sum);
+}
+
+template <class Queue>
+void run(const char* name, Queue& q, int threads) {
+    long pairs = kPairs / threads;
+    std::vector<std::vector<double> > samples(threads);
+    std::vector<std::thread> pool;
+    bench_timer t;
+    for (int i = 0; i < threads; ++i)
+        pool.push_back(std::thread(worker<Queue>, std::ref(q), pairs,
+                                   std::ref(samples[i])));
+    for (int i = 0; i < threads; ++i) pool[i].join();
+    double ms = t.elapsed_ms();
+
+    std::vector<double> all;
+    for (int i = 0; i < threads; ++i)
+        all.insert(all.end(), samples[i].begin(), samples[i].end());
+    std::sort(all.begin(), all.end());
+    double ops = 2.0 * pairs * threads;
+    printf("%-14s %3d threads %8.2f Mops/s  p50 %8.0f ns  p99 %8.0f ns"
+           "  p99.9 %10.0f ns\n",
+           name, threads, ops / ms / 1000.0, all[all.size() / 2],
+           all[all.size() * 99 / 100], all[all.size() * 999 / 1000]);
+}
+
+int main() {
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        locked_queue lq;
+        run("mutex+queue", lq, threads);
+        mpmc_queue<long> mq(1024);
+        run("mpmc_queue", mq, threads);
+    }
+    return 0;
+}
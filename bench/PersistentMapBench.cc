@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "../Map.h"
+#include "../PersistentMap.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+const int kSnapshots = 10;
+const int kUpdatesPerSnapshot = 1000;
+
+//默认的内存池本身很慢，两边都用malloc_alloc
+typedef map<int, int, std::less<int>, malloc_alloc> malloc_map;
+typedef persistent_map<int, int> pmap;
+
+int main() {
+    std::vector<int> keys;
+    for (int i = 0; i < kElements; ++i) keys.push_back(i);
+    std::random_shuffle(keys.begin(), keys.end());
+
+    bench_timer t;
+    malloc_map m;
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(std::make_pair(keys[i], int(i)));
+    report("insert 1M random", "map", t.elapsed_ms());
+    t.reset();
+    pmap p;
+    for (size_t i = 0; i < keys.size(); ++i)
+        p.insert(std::make_pair(keys[i], int(i)));
+    report("insert 1M random", "persistent_map", t.elapsed_ms());
+
+    long sum = 0;
+    t.reset();
+    for (size_t i = 0; i < keys.size(); ++i) sum += m.find(keys[i])->second;
+    report("find 1M random", "map", t.elapsed_ms());
+    t.reset();
+    for (size_t i = 0; i < keys.size(); ++i) sum += p.find(keys[i])->second;
+    report("find 1M random", "persistent_map", t.elapsed_ms());
+
+    //每改1000个键给读者一份快照，共10份，快照都保留到最后
+    std::vector<malloc_map> copies;
+    t.reset();
+    for (int s = 0, k = 0; s < kSnapshots; ++s) {
+        copies.push_back(m);
+        for (int u = 0; u < kUpdatesPerSnapshot; ++u, ++k)
+            m[keys[k]] = -k;
+    }
+    report("10 snapshots + 10K upd", "map (copy)", t.elapsed_ms());
+    std::vector<pmap> snaps;
+    t.reset();
+    for (int s = 0, k = 0; s < kSnapshots; ++s) {
+        snaps.push_back(p);
+        for (int u = 0; u < kUpdatesPerSnapshot; ++u, ++k)
+            p.insert_or_assign(keys[k], -k);
+    }
+    report("10 snapshots + 10K upd", "persistent_map", t.elapsed_ms());
+
+    t.reset();
+    for (pmap::const_iterator it = snaps[0].begin(); it != snaps[0].end(); ++it)
+        sum += it->second;
+    report("iterate snapshot 1M", "persistent_map", t.elapsed_ms());
+    do_not_optimize(sum);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <mutex>
+#include <thread>
+#include "../Queue.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kItems = 20000000;
+const size_t kBatch = 64;
+
+//每秒百万次操作
+inline double mops(double ms) { return kItems / ms / 1000.0; }
+
+void bench_locked_queue() {
+    queue<long> q;
+    std::mutex m;
+    bench_timer t;
+    std::thread producer([&] {
+        for (long i = 0; i < kItems; ++i) {
+            std::lock_guard<std::mutex> lock(m);
+            q.push(i);
+        }
+    });
+    long sum = 0;
+    for (long got = 0; got < kItems;) {
+        bool popped = false;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (!q.empty()) {
+                sum += q.front();
+                q.pop();
+                popped = true;
+            }
+        }
+        if (popped)
+            ++got;
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    do_not_optimize(sum);
+    double ms = t.elapsed_ms();
+    report("spsc 20M", "mutex+queue", ms);
+    printf("%-28s %-20s %10.2f Mops/s\n", "", "", mops(ms));
+}
+
+void bench_spsc() {
+    spsc_queue<long> q(4096);
+    bench_timer t;
+    std::thread producer([&] {
+        for (long i = 0; i < kItems; ++i)
+            while (!q.try_push(i)) std::this_thread::yield();
+    });
+    long sum = 0, x;
+    for (long got = 0; got < kItems;)
+        if (q.try_pop(x)) {
+            sum += x;
+            ++got;
+        } else
+            std::this_thread::yield();
+    producer.join();
+    do_not_optimize(sum);
+    double ms = t.elapsed_ms();
+    report("spsc 20M", "spsc_queue", ms);
+    printf("%-28s %-20s %10.2f Mops/s\n", "", "", mops(ms));
+}
+
+void bench_spsc_batch() {
+    spsc_queue<long> q(4096);
+    bench_timer t;
+    std::thread producer([&] {
+        long buf[kBatch];
+        for (long i = 0; i < kItems;) {
+            size_t n = kItems - i < (long)kBatch ? kItems - i : kBatch;
+            for (size_t k = 0; k < n; ++k) buf[k] = i + k;
+            size_t pushed = q.push_n(buf, n);
+            if (pushed == 0) std::this_thread::yield();
+            i += pushed;
+        }
+    });
+    long sum = 0, buf[kBatch];
+    for (long got = 0; got < kItems;) {
+        size_t n = q.pop_n(buf, kBatch);
+        if (n == 0) std::this_thread::yield();
+        for (size_t k = 0; k < n; ++k) sum += buf[k];
+        got += n;
+    }
+    producer.join();
+    do_not_optimize(sum);
+    double ms = t.elapsed_ms();
+    report("spsc 20M (batch 64)", "spsc_queue", ms);
+    printf("%-28s %-20s %10.2f Mops/s\n", "", "", mops(ms));
+}
+
+int main() {
+    bench_locked_queue();
+    bench_spsc();
+    bench_spsc_batch();
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <vector>
+#include "../Iterator.h"
+#include "../Set.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+const int kQueries = 20;
+
+//默认的内存池本身很慢，用malloc_alloc单独比较维护子树大小的开销
+typedef set<int, std::less<int>, malloc_alloc> plain_set;
+typedef set<int, std::less<int>, malloc_alloc, __rb_tree_rank_node_base>
+    rank_set;
+
+template <class Set>
+void bench_insert_erase(const std::vector<int>& keys, const char* name) {
+    bench_timer t;
+    Set s;
+    for (size_t i = 0; i < keys.size(); ++i) s.insert(keys[i]);
+    for (size_t i = 0; i < keys.size(); i += 2) s.erase(keys[i]);
+    report("insert 1M, erase 500K", name, t.elapsed_ms());
+    do_not_optimize(s);
+}
+
+//没有子树大小时只能从begin()走过去
+void bench_walk(const plain_set& s, const std::vector<int>& ks) {
+    long sum = 0;
+    bench_timer t;
+    for (size_t i = 0; i < ks.size(); ++i) {
+        plain_set::iterator it = s.begin();
+        TinySTL::advance(it, ks[i]);
+        sum += *it + TinySTL::distance(s.begin(), s.find(*it));
+    }
+    do_not_optimize(sum);
+    report("k-th + distance x20", "advance", t.elapsed_ms());
+}
+
+void bench_select(const rank_set& s, const std::vector<int>& ks) {
+    long sum = 0;
+    bench_timer t;
+    for (size_t i = 0; i < ks.size(); ++i) {
+        int x = *s.select(ks[i]);
+        sum += x + s.distance(s.begin(), s.find(x));
+    }
+    do_not_optimize(sum);
+    report("k-th + distance x20", "select", t.elapsed_ms());
+}
+
+int main() {
+    std::vector<int> keys;
+    for (int i = 0; i < kElements; ++i) keys.push_back(i);
+    std::random_shuffle(keys.begin(), keys.end());
+    bench_insert_erase<plain_set>(keys, "set");
+    bench_insert_erase<rank_set>(keys, "ranked set");
+
+    plain_set p(keys.begin(), keys.end());
+    rank_set r(keys.begin(), keys.end());
+    std::vector<int> ks;
+    for (int i = 0; i < kQueries; ++i) ks.push_back(keys[i]);
+    bench_walk(p, ks);
+    bench_select(r, ks);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <utility>
+#include "../Set.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+//默认的内存池不归还内存，反复复制大集合会占满内存，这里都用malloc_alloc
+typedef set<int, std::less<int>, malloc_alloc> int_set;
+
+const int kLarge = 1000000;
+
+// a为0, 2, 4, ...共kLarge个，b从offset开始每隔step取一个，共n个
+void make_sets(int_set& a, int_set& b, int n, int step, int offset) {
+    for (int i = 0; i < kLarge; ++i) a.insert(a.end(), i * 2);
+    for (int i = 0; i < n; ++i) b.insert(b.end(), offset + i * step);
+}
+
+void bench_algebra(int n, int step, const char* label) {
+    int_set a, b;
+    make_sets(a, b, n, step, 1);  //一半和a重复
+    long sum = 0;
+    printf("%s\n", label);
+
+    int_set x(a), y(b);
+    bench_timer t;
+    for (int_set::iterator it = y.begin(); it != y.end(); ++it) x.insert(*it);
+    report("union, insert loop", "set", t.elapsed_ms());
+    sum += x.size();
+    x = a;
+    t.reset();
+    x.set_union(y);
+    report("union, set_union", "set", t.elapsed_ms());
+    sum += x.size();
+
+    x = a;
+    t.reset();
+    for (int_set::iterator it = b.begin(); it != b.end(); ++it) x.erase(*it);
+    report("difference, erase loop", "set", t.elapsed_ms());
+    sum += x.size();
+    x = a;
+    t.reset();
+    x.set_difference(b);
+    report("difference, set_difference", "set", t.elapsed_ms());
+    sum += x.size();
+
+    x = a;
+    t.reset();
+    {  //结果换回x，原来的元素随z销毁，和原地求交集做的事相同
+        int_set z;
+        for (int_set::iterator it = b.begin(); it != b.end(); ++it)
+            if (x.count(*it)) z.insert(z.end(), *it);
+        x.swap(z);
+    }
+    report("intersection, find loop", "set", t.elapsed_ms());
+    sum += x.size();
+    x = a;
+    t.reset();
+    x.set_intersection(b);
+    report("intersect, set_intersection", "set", t.elapsed_ms());
+    sum += x.size();
+    do_not_optimize(sum);
+}
+
+int main() {
+    bench_algebra(1000, 1999, "1M x 1K:");
+    bench_algebra(kLarge, 1, "1M x 1M:");
+
+    int_set a, b;
+    make_sets(a, b, 0, 1, 0);
+    bench_timer t;
+    a.split(kLarge, b);  //从中间分开
+    report("split 1M in half", "set", t.elapsed_ms());
+    t.reset();
+    a.join(b);
+    report("join 500K + 500K", "set", t.elapsed_ms());
+    do_not_optimize(a.size());
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <mutex>
+#include <thread>
+#include "../Stack.h"
+#include "../Vector.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kItems = 20000000;
+const long kDepth = 1000;  //单线程时每压入这么多个元素再全部弹出
+
+//底层vector预先reserve，push不再搬移
+class reserved_vector_stack : public stack<long, vector<long> > {
+   public:
+    explicit reserved_vector_stack(size_t n) { c.reserve(n); }
+};
+
+template <class Stack>
+void bench_single(Stack& s, const char* name) {
+    long sum = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; i += kDepth) {
+        for (long k = 0; k < kDepth; ++k) s.push(k);
+        for (long k = 0; k < kDepth; ++k) {
+            sum += s.top();
+            s.pop();
+        }
+    }
+    do_not_optimize(sum);
+    report("single thread 20M", name, t.elapsed_ms());
+}
+
+void bench_single_lock_free() {
+    lock_free_stack<long> s(kDepth);
+    long sum = 0, x = 0;
+    bench_timer t;
+    for (long i = 0; i < kItems; i += kDepth) {
+        for (long k = 0; k < kDepth; ++k) s.try_push(k);
+        for (long k = 0; k < kDepth; ++k) {
+            s.try_pop(x);
+            sum += x;
+        }
+    }
+    do_not_optimize(sum);
+    report("single thread 20M", "lock_free_stack", t.elapsed_ms());
+}
+
+//每个线程交替push/pop，共kItems对操作，两种栈每个操作都单独同步一次
+void bench_mutex_stack(int threads) {
+    stack<long> s;
+    std::mutex m;
+    std::thread workers[64];
+    bench_timer t;
+    for (int k = 0; k < threads; ++k)
+        workers[k] = std::thread([&s, &m, threads] {
+            long sum = 0;
+            for (long i = 0; i < kItems / threads; ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    s.push(i);
+                }
+                std::lock_guard<std::mutex> lock(m);
+                sum += s.top();
+                s.pop();
+            }
+            do_not_optimize(sum);
+        });
+    for (int k = 0; k < threads; ++k) workers[k].join();
+    char name[32];
+    snprintf(name, sizeof(name), "%d threads 20M", threads);
+    report(name, "mutex+stack", t.elapsed_ms());
+}
+
+void bench_lock_free_stack(int threads) {
+    lock_free_stack<long> s(threads);
+    std::thread workers[64];
+    bench_timer t;
+    for (int k = 0; k < threads; ++k)
+        workers[k] = std::thread([&s, threads] {
+            long sum = 0, x;
+            for (long i = 0; i < kItems / threads; ++i) {
+                s.try_push(i);  //节点数等于线程数，push不会失败
+                while (!s.try_pop(x)) std::this_thread::yield();
+                sum += x;
+            }
+            do_not_optimize(sum);
+        });
+    for (int k = 0; k < threads; ++k) workers[k].join();
+    char name[32];
+    snprintf(name, sizeof(name), "%d threads 20M", threads);
+    report(name, "lock_free_stack", t.elapsed_ms());
+}
+
+int main() {
+    stack<long> deque_stack;
+    bench_single(deque_stack, "stack<deque>");
+    reserved_vector_stack vector_stack(kDepth);
+    bench_single(vector_stack, "stack<vector>+reserve");
+    bench_single_lock_free();
+
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        bench_mutex_stack(threads);
+        bench_lock_free_stack(threads);
+    }
+    return 0;
+}
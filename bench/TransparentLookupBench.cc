@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "../Map.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 100000;
+const int kLookups = 1000000;
+
+//统计operator new的调用次数，看查找时有没有构造临时的std::string
+static size_t allocations = 0;
+void* operator new(size_t n) {
+    ++allocations;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+
+template <class Map>
+void bench_lookup(const std::vector<std::string>& keys, const char* name) {
+    Map m;
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(typename Map::value_type(keys[i], int(i)));
+    //查询来自C字符串，例如从网络或文件里解析出来的
+    std::vector<const char*> probes;
+    for (int i = 0; i < kLookups; ++i)
+        probes.push_back(keys[size_t(i) * 7919 % keys.size()].c_str());
+
+    long sum = 0;
+    size_t before = allocations;
+    bench_timer t;
+    for (size_t i = 0; i < probes.size(); ++i)
+        sum += m.find(probes[i])->second;
+    double ms = t.elapsed_ms();
+    report("find 1M by const char*", name, ms);
+    printf("%-28s %-20s %10zu allocations\n", "", name,
+           allocations - before);
+    do_not_optimize(sum);
+}
+
+int main() {
+    //键比短字符串优化的容量长，构造临时std::string一定会配置内存
+    std::vector<std::string> keys;
+    char buf[64];
+    for (int i = 0; i < kElements; ++i) {
+        snprintf(buf, sizeof(buf), "user/session/%08d/profile", i * 13);
+        keys.push_back(buf);
+    }
+
+    typedef map<std::string, int, std::less<std::string>, malloc_alloc>
+        plain_map;
+    typedef map<std::string, int, transparent_less, malloc_alloc>
+        transparent_map;
+    bench_lookup<plain_map>(keys, "std::less<string>");
+    bench_lookup<transparent_map>(keys, "transparent_less");
+    return 0;
+}
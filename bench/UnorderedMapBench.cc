@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../Map.h"
+#include "../UnorderedMap.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+
+//默认的内存池本身很慢，红黑树用malloc_alloc；哈希表的槽数组本来就走malloc
+typedef map<int, int, std::less<int>, malloc_alloc> malloc_map;
+
+template <class Map>
+void bench_map(const std::vector<int>& keys, const std::vector<int>& probes,
+               const char* name) {
+    Map m;
+    bench_timer t;
+    for (size_t i = 0; i < keys.size(); ++i)
+        m.insert(std::pair<const int, int>(keys[i], int(i)));
+    report("insert 1M random", name, t.elapsed_ms());
+
+    long sum = 0;
+    t.reset();
+    for (size_t i = 0; i < probes.size(); ++i) {
+        typename Map::const_iterator it = m.find(probes[i]);
+        if (it != m.end()) sum += it->second;
+    }
+    report("find 1M random, 50% hit", name, t.elapsed_ms());
+
+    t.reset();
+    for (int round = 0; round < 5; ++round)
+        for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+            sum += it->second;
+    report("iterate 1M x5", name, t.elapsed_ms());
+
+    t.reset();
+    for (size_t i = 0; i < keys.size(); i += 2) m.erase(keys[i]);
+    report("erase 500K random", name, t.elapsed_ms());
+
+    //删除后再查找，探测序列要越过删除留下的槽
+    t.reset();
+    for (size_t i = 0; i < probes.size(); ++i) sum += m.count(probes[i]);
+    report("find after erase", name, t.elapsed_ms());
+    do_not_optimize(sum);
+}
+
+int main() {
+    std::vector<int> keys, probes;
+    for (int i = 0; i < kElements; ++i) keys.push_back(i * 2);
+    std::random_shuffle(keys.begin(), keys.end());
+    for (int i = 0; i < kElements; ++i) probes.push_back(keys[i] + i % 2);
+    std::random_shuffle(probes.begin(), probes.end());
+
+    bench_map<malloc_map>(keys, probes, "rb_tree map");
+    bench_map<std::unordered_map<int, int> >(keys, probes,
+                                             "std::unordered_map");
+    bench_map<unordered_map<int, int> >(keys, probes, "unordered_map");
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../Deque.h"
+#include "../List.h"
+#include "../UnrolledList.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const int kElements = 1000000;
+const int kRounds = 20;
+
+template <class Container>
+void bench_push_back(const char* name) {
+    bench_timer t;
+    Container c;
+    for (int i = 0; i < kElements; ++i) c.push_back(i);
+    report("push_back 1M", name, t.elapsed_ms());
+}
+
+template <class Container>
+void bench_iterate(const char* name) {
+    Container c;
+    for (int i = 0; i < kElements; ++i) c.push_back(i);
+    bench_timer t;
+    long long sum = 0;
+    for (int r = 0; r < kRounds; ++r)
+        for (typename Container::iterator it = c.begin(); it != c.end(); ++it)
+            sum += *it;
+    do_not_optimize(sum);
+    report("iterate 1M x20", name, t.elapsed_ms());
+}
+
+//边走边在迭代器处插入，模拟"在当前位置附近插入"
+template <class Container>
+void bench_insert_near(const char* name) {
+    Container c;
+    for (int i = 0; i < kElements / 10; ++i) c.push_back(i);
+    bench_timer t;
+    typename Container::iterator it = c.begin();
+    for (int i = 0; it != c.end(); ++i) {
+        it = c.insert(it, i);
+        ++it;
+        if (it != c.end()) ++it;
+    }
+    do_not_optimize(c.size());
+    report("insert near iterator 100K", name, t.elapsed_ms());
+}
+
+int main() {
+    bench_push_back<list<int> >("list<int>");
+    bench_push_back<deque<int> >("deque<int>");
+    bench_push_back<unrolled_list<int> >("unrolled_list<int,16>");
+    bench_push_back<unrolled_list<int, 64> >("unrolled_list<int,64>");
+
+    bench_iterate<list<int> >("list<int>");
+    bench_iterate<deque<int> >("deque<int>");
+    bench_iterate<unrolled_list<int> >("unrolled_list<int,16>");
+    bench_iterate<unrolled_list<int, 64> >("unrolled_list<int,64>");
+
+    bench_insert_near<list<int> >("list<int>");
+    bench_insert_near<deque<int> >("deque<int>");
+    bench_insert_near<unrolled_list<int> >("unrolled_list<int,16>");
+    bench_insert_near<unrolled_list<int, 64> >("unrolled_list<int,64>");
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../Deque.h"
+#include "../WorkStealingDeque.h"
+#include "Bench.h"
+
+using namespace TinySTL;
+
+const long kTasks = 4000000;
+
+//互斥锁保护的deque，作为对照
+class locked_deque {
+   public:
+    void push(long x) {
+        std::lock_guard<std::mutex> lock(m);
+        d.push_back(x);
+    }
+    bool pop(long& x) {
+        std::lock_guard<std::mutex> lock(m);
+        if (d.empty()) return false;
+        x = d.back();
+        d.pop_back();
+        return true;
+    }
+    bool steal(long& x) {
+        std::lock_guard<std::mutex> lock(m);
+        if (d.empty()) return false;
+        x = d.front();
+        d.pop_front();
+        return true;
+    }
+    bool empty() {
+        std::lock_guard<std::mutex> lock(m);
+        return d.empty();
+    }
+
+   private:
+    std::mutex m;
+    deque<long> d;
+};
+
+//拥有者push全部任务，每push 4个自己pop 1个，其余由窃取者steal
+template <class Queue>
+void run(const char* container, int thieves) {
+    Queue q;
+    std::atomic<bool> done(false);
+    std::atomic<long> stolen(0);
+    std::vector<std::thread> pool;
+    bench_timer t;
+    for (int k = 0; k < thieves; ++k)
+        pool.push_back(std::thread([&] {
+            long x, sum = 0, n = 0;
+            while (!done.load(std::memory_order_relaxed) || !q.empty())
+                if (q.steal(x)) {
+                    sum += x;
+                    ++n;
+                } else
+                    std::this_thread::yield();
+            stolen += n;
+            do_not_optimize(sum);
+        }));
+    long x, sum = 0;
+    for (long i = 0; i < kTasks; ++i) {
+        q.push(i);
+        if ((i & 3) == 0 && q.pop(x)) sum += x;
+    }
+    while (q.pop(x)) sum += x;
+    done = true;
+    for (int k = 0; k < thieves; ++k) pool[k].join();
+    double ms = t.elapsed_ms();
+    do_not_optimize(sum);
+    printf("%-22s %2d thieves %9.2f ms %8.2f Mtasks/s  stolen %ld\n",
+           container, thieves, ms, kTasks / ms / 1000.0, stolen.load());
+}
+
+int main() {
+    for (int thieves = 1; thieves <= 8; thieves *= 2) {
+        run<locked_deque>("mutex+deque", thieves);
+        run<work_stealing_deque<long> >("work_stealing_deque", thieves);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../BTreeMap.h"
+#include "../BTreeSet.h"
+
+using namespace TinySTL;
+
+//节点只放3个值，树很深，分裂合并和借位都会频繁发生
+typedef btree<int, std::pair<const int, std::string>,
+              select1st<std::pair<const int, std::string> >, std::less<int>,
+              alloc, 64>
+    small_node_tree;
+
+TEST(BTreeTest,testRandomOps){
+    small_node_tree t;
+    std::map<int, std::string> ref;
+    srand(7);
+    for (int i = 0; i < 5000; ++i) {
+        int k = rand() % 300;
+        if (rand() % 3) {
+            std::pair<const int, std::string> v(k, std::to_string(k));
+            EXPECT_EQ(ref.insert(v).second,t.insert_unique(v).second);
+        } else
+            EXPECT_EQ(ref.erase(k),t.erase(k));
+        ASSERT_TRUE(t.__btree_verify());
+    }
+    EXPECT_EQ(ref.size(),t.size());
+    std::map<int, std::string>::iterator r = ref.begin();
+    for (small_node_tree::iterator it = t.begin(); it != t.end(); ++it, ++r) {
+        EXPECT_EQ(r->first,it->first);
+        EXPECT_EQ(r->second,it->second);
+    }
+    small_node_tree c(t);
+    EXPECT_TRUE(c.__btree_verify());
+    EXPECT_TRUE(c == t);
+    c.erase(c.lower_bound(100), c.upper_bound(200));
+    EXPECT_TRUE(c.__btree_verify());
+    EXPECT_TRUE(c.lower_bound(100) == c.upper_bound(200));
+}
+
+//复制时可以按要求抛出异常的值，移动不抛出
+struct throwing_copy {
+    int k;
+    static bool fail;
+    explicit throwing_copy(int k) : k(k) {}
+    throwing_copy(const throwing_copy& x) : k(x.k) {
+        if (fail) throw std::runtime_error("copy");
+    }
+    throwing_copy(throwing_copy&& x) noexcept : k(x.k) {}
+};
+bool throwing_copy::fail = false;
+
+struct throwing_copy_key {
+    const int& operator()(const throwing_copy& x) const { return x.k; }
+};
+
+//每个节点6个值
+typedef btree<int, throwing_copy, throwing_copy_key, std::less<int>, alloc,
+              2 * sizeof(void*) + 6 * sizeof(throwing_copy)>
+    throwing_tree;
+
+TEST(BTreeTest,testThrowingCopy){
+    //顺序插入时满叶子在末尾分裂，新节点是空的，复制失败不能把它留在树里
+    throwing_tree t;
+    size_t n = 0;
+    for (int i = 0; i < 300; ++i) {
+        throwing_copy::fail = i % 7 == 6;
+        if (throwing_copy::fail)
+            EXPECT_THROW(t.insert_unique(throwing_copy(i)),std::runtime_error);
+        else {
+            EXPECT_TRUE(t.insert_unique(throwing_copy(i)).second);
+            ++n;
+        }
+        ASSERT_TRUE(t.__btree_verify());
+    }
+    throwing_copy::fail = false;
+    EXPECT_EQ(n,t.size());
+    int prev = -1;
+    for (throwing_tree::iterator it = t.begin(); it != t.end(); ++it) {
+        EXPECT_LT(prev,it->k);
+        EXPECT_NE(6,it->k % 7);
+        prev = it->k;
+    }
+    //逆序插入，在节点开头分裂
+    throwing_tree r;
+    for (int i = 300; i > 0; --i) {
+        throwing_copy::fail = i % 5 == 0;
+        if (throwing_copy::fail)
+            EXPECT_THROW(r.insert_unique(throwing_copy(i)),std::runtime_error);
+        else
+            r.insert_unique(throwing_copy(i));
+        ASSERT_TRUE(r.__btree_verify());
+    }
+    throwing_copy::fail = false;
+    EXPECT_EQ(240u,r.size());
+}
+
+typedef btree<int, int, identity<int>, std::less<int>, alloc,
+              2 * sizeof(void*) + 3 * sizeof(int)>
+    tree3;
+typedef btree<int, int, identity<int>, std::less<int>, alloc,
+              2 * sizeof(void*) + 6 * sizeof(int)>
+    tree6;
+typedef btree<int, int, identity<int>, std::less<int>, alloc,
+              2 * sizeof(void*) + 7 * sizeof(int)>
+    tree7;
+typedef btree<int, int, identity<int>, std::less<int> > tree60;
+
+template <class Tree>
+bool same_as(const Tree& t, const std::set<int>& ref) {
+    return t.__btree_verify() && t.size() == ref.size() &&
+           std::equal(ref.begin(), ref.end(), t.begin());
+}
+
+template <class Tree>
+void check_biased_split_underflow() {
+    //顺序插入时分裂偏向一端，左边的节点是满的，右边新节点只有一个值；
+    //逆序插入则相反。之后隔一个删一个，节点从满到不足一半，反复借位和合并
+    const int n = 3000;
+    for (int order = 0; order < 2; ++order) {
+        Tree t;
+        std::set<int> ref;
+        for (int i = 0; i < n; ++i) {
+            int k = order == 0 ? i : n - 1 - i;
+            t.insert_unique(k);
+            ref.insert(k);
+        }
+        ASSERT_TRUE(same_as(t, ref));
+        for (int i = order; i < n; i += 2) {
+            EXPECT_EQ(1u,t.erase(i));
+            ref.erase(i);
+            ASSERT_TRUE(t.__btree_verify());
+        }
+        EXPECT_TRUE(same_as(t, ref));
+        //从偏空的一端删到空，根最后降为叶子
+        while (!ref.empty()) {
+            int k = order == 0 ? *ref.rbegin() : *ref.begin();
+            EXPECT_EQ(1u,t.erase(k));
+            ref.erase(k);
+            ASSERT_TRUE(t.__btree_verify());
+        }
+        EXPECT_TRUE(t.begin() == t.end());
+    }
+}
+
+TEST(BTreeTest,testBiasedSplitUnderflow){
+    check_biased_split_underflow<tree3>();
+    check_biased_split_underflow<tree6>();
+    check_biased_split_underflow<tree7>();
+    check_biased_split_underflow<tree60>();
+}
+
+template <class Tree>
+void check_internal_erase() {
+    //每次删掉遍历时遇到的第一个内部节点中的值，换上叶子中的前驱再调整
+    Tree t;
+    std::set<int> ref;
+    srand(11);
+    for (int i = 0; i < 4000; ++i) {
+        int k = rand() % 10000;
+        t.insert_unique(k);
+        ref.insert(k);
+    }
+    int erased = 0;
+    for (;;) {
+        typename Tree::iterator it = t.begin();
+        while (it != t.end() && it.node->leaf) ++it;
+        if (it == t.end()) break;
+        ref.erase(*it);
+        t.erase(it);
+        ++erased;
+        ASSERT_TRUE(t.__btree_verify());
+    }
+    EXPECT_LT(0,erased);
+    EXPECT_TRUE(same_as(t, ref));
+    EXPECT_TRUE(t.size() <= (size_t)Tree::node_values);  //只剩一个叶子根
+}
+
+TEST(BTreeTest,testInternalErase){
+    check_internal_erase<tree3>();
+    check_internal_erase<tree6>();
+    check_internal_erase<tree7>();
+    check_internal_erase<tree60>();
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../CircularBuffer.h"
+
+using namespace TinySTL;
+
+TEST(CircularBufferTest,testPushPop){
+    circular_buffer<int> b(4);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(4u,b.capacity());
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(b.push_back(i));
+    EXPECT_TRUE(b.full());
+    EXPECT_FALSE(b.push_back(4));  //默认满了拒绝
+    EXPECT_FALSE(b.push_front(-1));
+
+    b.pop_front();
+    b.pop_front();
+    EXPECT_TRUE(b.push_back(4));  //回绕到存储区头
+    EXPECT_TRUE(b.push_front(1));
+    EXPECT_EQ(4u,b.size());
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(i + 1,b[i]);
+    EXPECT_EQ(1,b.front());
+    EXPECT_EQ(4,b.back());
+
+    b.pop_back();
+    EXPECT_EQ(3,b.back());
+    b.clear();
+    EXPECT_TRUE(b.empty());
+}
+
+TEST(CircularBufferTest,testOverwrite){
+    circular_buffer<std::string> b(3, true);
+    for (int i = 0; i < 10; ++i) b.push_back(std::string(1, char('a' + i)));
+    EXPECT_EQ(3u,b.size());
+    EXPECT_EQ("h",b.front());
+    EXPECT_EQ("j",b.back());
+
+    b.push_front("x");  //挤掉最晚的元素
+    EXPECT_EQ("x",b[0]);
+    EXPECT_EQ("h",b[1]);
+    EXPECT_EQ("i",b[2]);
+
+    circular_buffer<std::string> c(b);
+    b.set_overwrite_mode(false);
+    EXPECT_FALSE(b.push_back("y"));
+    EXPECT_TRUE(c.push_back("y"));
+    EXPECT_EQ("h",c.front());
+    EXPECT_EQ("y",c.back());
+    c = b;
+    EXPECT_EQ("x",c.front());
+    EXPECT_FALSE(c.overwrite_mode());
+}
+
+TEST(CircularBufferTest,testIteratorsAndSpans){
+    circular_buffer<int> b(8, true);
+    for (int i = 0; i < 13; ++i) b.push_back(i);  //内容是5..12，首元素在下标5
+
+    circular_buffer<int>::array_range one = b.array_one(), two = b.array_two();
+    EXPECT_EQ(3u,one.second);
+    EXPECT_EQ(5u,two.second);
+    EXPECT_EQ(5,one.first[0]);
+    EXPECT_EQ(8,two.first[0]);
+    EXPECT_EQ(12,two.first[4]);
+
+    circular_buffer<int>::iterator it = b.begin();
+    EXPECT_EQ(8,b.end() - it);
+    EXPECT_EQ(9,it[4]);
+    it += 6;
+    EXPECT_EQ(11,*it);
+    EXPECT_EQ(10,*--it);
+    EXPECT_TRUE(b.begin() < it);
+    int expect = 5;
+    for (circular_buffer<int>::const_iterator i = b.begin(); i != b.end(); ++i)
+        EXPECT_EQ(expect++,*i);
+
+    b.pop_front(4);  //越过存储区尾
+    EXPECT_EQ(4u,b.size());
+    EXPECT_EQ(9,b.front());
+    EXPECT_EQ(4u,b.array_one().second);
+    EXPECT_EQ(0u,b.array_two().second);
+}
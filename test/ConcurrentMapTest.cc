@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "../ConcurrentMap.h"
+
+using namespace TinySTL;
+
+typedef concurrent_map<int, std::string> string_map;
+
+TEST(ConcurrentMapTest,testOrdered){
+    string_map m;
+    for (int i = 99; i >= 0; --i)
+        EXPECT_TRUE(m.insert(string_map::value_type(i * 2, std::to_string(i)))
+                        .second);
+    EXPECT_FALSE(m.insert(string_map::value_type(10, "x")).second);
+    EXPECT_EQ(100u,m.size());
+
+    std::string v;
+    EXPECT_TRUE(m.find(10, v));
+    EXPECT_EQ("5",v);
+    EXPECT_FALSE(m.find(11, v));
+    EXPECT_EQ(1u,m.count(198));
+
+    EXPECT_EQ(12,m.lower_bound(11)->first);
+    EXPECT_EQ(12,m.upper_bound(10)->first);
+    EXPECT_TRUE(m.lower_bound(199) == m.end());
+
+    for (int i = 0; i < 200; i += 4) EXPECT_EQ(1u,m.erase(i));
+    EXPECT_EQ(0u,m.erase(0));
+    EXPECT_EQ(50u,m.size());
+    EXPECT_TRUE(m.find(8) == m.end());
+    EXPECT_EQ(10,m.lower_bound(7)->first);
+
+    int expect = 2, n = 0;
+    for (string_map::const_iterator i = m.begin(); i != m.end(); ++i, ++n) {
+        EXPECT_EQ(expect,i->first);
+        expect += 4;
+    }
+    EXPECT_EQ(50,n);
+}
+
+TEST(ConcurrentMapTest,testThreads){
+    const int threads = 4, n = 20000;
+    concurrent_map<int, int> m;
+    std::atomic<int> misses(0);
+    std::thread workers[threads];
+    for (int t = 0; t < threads; ++t) {
+        workers[t] = std::thread([&m, &misses, t] {
+            //各线程插入交错的键，删掉其中一半，同时读别的线程的键
+            for (int i = t; i < n; i += threads) {
+                m.insert(std::pair<const int, int>(i, -i));
+                int v;
+                if (m.find(i, v) && v != -i) ++misses;
+                if (i % 2) m.erase(i);
+                m.find((i * 7) % n, v);
+            }
+        });
+    }
+    for (int t = 0; t < threads; ++t) workers[t].join();
+    EXPECT_EQ(0,misses.load());
+    EXPECT_EQ(size_t(n / 2),m.size());
+    int expect = 0;
+    for (concurrent_map<int, int>::const_iterator i = m.begin(); i != m.end();
+         ++i) {
+        EXPECT_EQ(expect,i->first);
+        EXPECT_EQ(-expect,i->second);
+        expect += 2;
+    }
+    EXPECT_EQ(n,expect);
+}
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "../Deque.h"
+
+using namespace TinySTL;
+
+struct DequeCountingAlloc {
+    static int count;
+    static void* allocate(size_t n) { ++count; return malloc(n); }
+    static void deallocate(void* p, size_t) { --count; free(p); }
+};
+int DequeCountingAlloc::count = 0;
+
+typedef deque<int, DequeCountingAlloc, 8> small_deque;
+
+TEST(DequeTest,testPushPop){
+    deque<int> d;
+    for (int i = 0; i < 1000; ++i) {
+        d.push_back(i);
+        d.push_front(-i);
+    }
+    EXPECT_EQ(2000u,d.size());
+    EXPECT_EQ(-999,d.front());
+    EXPECT_EQ(999,d.back());
+    EXPECT_EQ(0,d[999]);
+
+    d.erase(d.begin() + 10, d.begin() + 1500);
+    EXPECT_EQ(510u,d.size());
+    EXPECT_EQ(-990,d[9]);
+    EXPECT_EQ(500,d[10]);
+}
+
+TEST(DequeTest,testSpareBuffers){
+    {
+        small_deque d;
+        for (int i = 0; i < 8; ++i) d.push_back(i);
+        d.push_front(0);  //前端留下一个备用缓冲区
+        d.pop_front();
+        int live = DequeCountingAlloc::count;
+        //在缓冲区边界上来回push/pop，不再配置新的缓冲区
+        for (int i = 0; i < 1000; ++i) {
+            d.push_back(i);
+            d.pop_back();
+            d.push_front(i);
+            d.pop_front();
+        }
+        EXPECT_EQ(live,DequeCountingAlloc::count);
+
+        //先进先出时从前端退下的缓冲区给尾端复用
+        for (int i = 0; i < 1000; ++i) {
+            d.push_back(i);
+            d.pop_front();
+        }
+        EXPECT_EQ(live,DequeCountingAlloc::count);
+        EXPECT_EQ(8u,d.size());
+        EXPECT_EQ(992,d.front());
+        EXPECT_EQ(999,d.back());
+
+        for (int i = 0; i < 100; ++i) d.push_back(i);
+        d.clear();
+        EXPECT_TRUE(d.empty());
+        d.shrink_to_fit();
+        d.push_back(1);
+        EXPECT_EQ(1,d.front());
+    }
+    EXPECT_EQ(0,DequeCountingAlloc::count);
+}
+
+//第fail_after次复制后抛出异常
+struct deque_thrower {
+    static int fail_after;
+    int v;
+    deque_thrower(int v = 0) : v(v) {}
+    deque_thrower(const deque_thrower& x) : v(x.v) {
+        if (fail_after >= 0 && fail_after-- == 0)
+            throw std::runtime_error("copy");
+    }
+};
+int deque_thrower::fail_after = -1;
+
+TEST(DequeTest,testSpareBuffersAfterThrow){
+    //区间插入先配置好缓冲区，复制中途失败后一端会留下多个备用缓冲区，
+    //之后map重新配置时不能溢出，也不能漏掉它们
+    {
+        deque<deque_thrower, DequeCountingAlloc, 8> d;
+        for (int i = 0; i < 4; ++i) d.push_back(i);
+        deque_thrower src[100];
+        for (int front = 0; front < 2; ++front) {
+            deque_thrower::fail_after = 50;
+            if (front)
+                EXPECT_THROW(d.insert(d.begin(), src, src + 100),
+                             std::runtime_error);
+            else
+                EXPECT_THROW(d.insert(d.end(), src, src + 100),
+                             std::runtime_error);
+            deque_thrower::fail_after = -1;
+            for (int i = 0; i < 200; ++i) d.push_front(i);  //扩张map
+            for (int i = 0; i < 200; ++i) d.push_back(i);
+            for (int i = 0; i < 200; ++i) d.pop_front();
+            for (int i = 0; i < 200; ++i) d.pop_back();
+        }
+        EXPECT_EQ(4u,d.size());
+        EXPECT_EQ(3,d.back().v);
+    }
+    EXPECT_EQ(0,DequeCountingAlloc::count);
+}
+
+TEST(DequeTest,testLazyAllocation){
+    {
+        small_deque a, b(a);
+        EXPECT_EQ(0,DequeCountingAlloc::count);  //默认构造和复制空deque都不配置
+        EXPECT_TRUE(a.empty());
+        EXPECT_EQ(0u,a.size());
+        EXPECT_TRUE(a.begin() == a.end());
+        a.clear();
+        a.erase(a.begin(), a.end());
+        EXPECT_EQ(0,DequeCountingAlloc::count);
+
+        a.push_front(1);
+        b.push_back(2);
+        EXPECT_EQ(1,a.front());
+        EXPECT_EQ(2,b.back());
+        a.pop_front();
+        a.shrink_to_fit();  //空了之后可以把map和缓冲区全部还回去
+        EXPECT_TRUE(a.empty());
+
+        a.insert(a.begin(), 20, 7);
+        EXPECT_EQ(20u,a.size());
+        EXPECT_EQ(7,a[19]);
+    }
+    EXPECT_EQ(0,DequeCountingAlloc::count);
+}
+
+template <class Deque>
+void checkRandomAccess(){
+    Deque d;
+    for (int i = 0; i < 100; ++i) d.push_back(i);
+    for (int i = 0; i < 7; ++i) d.pop_front();
+    for (int i = 0; i < 93; ++i) EXPECT_EQ(i + 7,d[i]);
+
+    typename Deque::iterator last = d.end();
+    for (int k = 1; k <= 93; ++k) {
+        typename Deque::iterator it = last - k;
+        EXPECT_EQ(100 - k,*it);
+        EXPECT_EQ(k,last - it);
+        EXPECT_TRUE(it + k == last);
+    }
+}
+
+TEST(DequeTest,testRandomAccess){
+    checkRandomAccess<deque<int> >();
+    checkRandomAccess<deque<int, alloc, 4> >();  //移位和掩码
+    checkRandomAccess<deque<int, alloc, 3> >();  //除法和取模
+}
+
+struct Sum {
+    int total;
+    Sum() : total(0) {}
+    void operator()(int x) { total += x; }
+};
+
+TEST(DequeTest,testSegmentedAlgorithms){
+    typedef deque<int, alloc, 4> small;
+    small a, b;
+    for (int i = 0; i < 30; ++i) a.push_back(i);
+    for (int i = 0; i < 33; ++i) b.push_back(-1);
+    b.pop_front();  //让两边的缓冲区边界错开
+
+    small::iterator r = copy(a.begin() + 1, a.begin() + 21, b.begin() + 3);
+    EXPECT_TRUE(r == b.begin() + 23);
+    EXPECT_EQ(-1,b[2]);
+    EXPECT_EQ(1,b[3]);
+    EXPECT_EQ(20,b[22]);
+    EXPECT_EQ(-1,b[23]);
+
+    //重叠区间向后搬
+    copy_backward(a.begin(), a.begin() + 20, a.begin() + 25);
+    EXPECT_EQ(4,a[4]);
+    EXPECT_EQ(0,a[5]);
+    EXPECT_EQ(19,a[24]);
+    EXPECT_EQ(25,a[25]);
+
+    fill(a.begin() + 2, a.begin() + 27, 7);
+    EXPECT_EQ(1,a[1]);
+    EXPECT_EQ(7,a[2]);
+    EXPECT_EQ(7,a[26]);
+    EXPECT_EQ(27,a[27]);
+
+    EXPECT_TRUE(find(a.begin(), a.end(), 28) == a.begin() + 28);
+    EXPECT_TRUE(find(a.begin(), a.end(), 100) == a.end());
+    EXPECT_EQ(0 + 1 + 25 * 7 + 27 + 28 + 29,
+              for_each(a.begin(), a.end(), Sum()).total);
+
+    small c(a);
+    EXPECT_TRUE(equal(a.begin(), a.end(), c.begin()));
+    c[29] = 0;
+    EXPECT_FALSE(equal(a.begin(), a.end(), c.begin()));
+}
+
+TEST(DequeTest,testInsertEraseStrings){
+    deque<std::string, alloc, 4> d;
+    for (int i = 0; i < 20; ++i) d.push_back(std::to_string(i));
+    d.insert(d.begin() + 3, 5, std::string("x"));
+    d.insert(d.end() - 2, 6, std::string("y"));
+    d.erase(d.begin() + 1, d.begin() + 4);
+    d.erase(d.end() - 10, d.end() - 3);
+
+    const char* expect[] = {"0", "x", "x", "x", "x",  "3",  "4",
+                            "5", "6", "7", "8", "9",  "10", "11",
+                            "12", "13", "14", "15", "y", "18", "19"};
+    ASSERT_EQ(21u,d.size());
+    for (int i = 0; i < 21; ++i) EXPECT_EQ(expect[i],d[i]);
+}
+
+TEST(DequeTest,testAssignRangeInsertStrings){
+    //元素类型在std中时，不加限定的distance/advance会因ADL而有歧义
+    deque<std::string, alloc, 4> a, b;
+    b.push_back("x");
+    b.push_back("y");
+    a = b;
+    ASSERT_EQ(2u,a.size());
+    EXPECT_EQ("y",a.back());
+
+    const std::string s[] = {"p", "q", "r", "s", "t", "u"};
+    for (int i = 0; i < 10; ++i) a.push_back(std::to_string(i));
+    a.insert(a.begin() + 1, s, s + 2);  //靠前，插入的比前面的元素多
+    a.insert(a.end() - 1, s, s + 6);    //靠后，插入的比后面的元素多
+    a.insert(a.begin() + 7, s + 2, s + 4);
+    const char* expect[] = {"x", "p", "q", "y", "0", "1", "2", "r", "s",
+                            "3", "4", "5", "6", "7", "8", "p", "q", "r",
+                            "s", "t", "u", "9"};
+    ASSERT_EQ(22u,a.size());
+    for (int i = 0; i < 22; ++i) EXPECT_EQ(expect[i],a[i]);
+}
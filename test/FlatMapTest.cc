@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../FlatMap.h"
+#include "../FlatSet.h"
+
+using namespace TinySTL;
+
+TEST(FlatMapTest,testBoundaries){
+    //无分支二分在每种长度下都要落到std::lower_bound/upper_bound的位置，
+    //长度取0到70，覆盖2的幂前后；键是偶数，查询奇数和两端之外的键
+    for (int n = 0; n <= 70; ++n) {
+        flat_set<int> s;
+        flat_set<int, std::greater<int> > r;
+        std::vector<int> v, rv;
+        for (int i = 0; i < n; ++i) {
+            s.insert(i * 2);
+            r.insert(i * 2);
+            v.push_back(i * 2);
+            rv.push_back((n - 1 - i) * 2);
+        }
+        for (int k = -1; k <= 2 * n + 1; ++k) {
+            EXPECT_EQ(std::lower_bound(v.begin(), v.end(), k) - v.begin(),
+                      s.lower_bound(k) - s.begin());
+            EXPECT_EQ(std::upper_bound(v.begin(), v.end(), k) - v.begin(),
+                      s.upper_bound(k) - s.begin());
+            EXPECT_EQ(std::lower_bound(rv.begin(), rv.end(), k,
+                                       std::greater<int>()) -
+                          rv.begin(),
+                      r.lower_bound(k) - r.begin());
+            EXPECT_EQ(std::upper_bound(rv.begin(), rv.end(), k,
+                                       std::greater<int>()) -
+                          rv.begin(),
+                      r.upper_bound(k) - r.begin());
+            EXPECT_EQ(k >= 0 && k < 2 * n && k % 2 == 0, s.count(k) == 1);
+        }
+    }
+}
+
+TEST(FlatMapTest,testBatchInsert){
+    std::vector<std::pair<int, int> > batch;
+    for (int i = 0; i < 1000; ++i) batch.push_back(std::make_pair(i % 500, i));
+    flat_map<int, int> m(batch.begin(), batch.end());
+    EXPECT_EQ(500u,m.size());
+    EXPECT_EQ(7,m[7]);  //相同的键保留第一个
+
+    //和已有元素归并，已有的键不变
+    std::map<int, int> ref(batch.begin(), batch.end());
+    std::vector<std::pair<int, int> > more;
+    for (int i = 0; i < 1000; ++i) more.push_back(std::make_pair(i * 3, -i));
+    m.insert(more.rbegin(), more.rend());
+    ref.insert(more.rbegin(), more.rend());
+    EXPECT_EQ(ref.size(),m.size());
+    std::map<int, int>::iterator r = ref.begin();
+    for (flat_map<int, int>::iterator it = m.begin(); it != m.end(); ++it, ++r)
+        EXPECT_TRUE(it->first == r->first && it->second == r->second);
+
+    flat_map<int, int> c(m);
+    EXPECT_TRUE(c == m);
+    c[5000] = 1;
+    EXPECT_TRUE(m < c);
+}
+
+TEST(FlatMapTest,testBatchMergeExisting){
+    flat_map<int, int> m;
+    for (int i = 0; i < 100; ++i) m[i * 2] = i;
+
+    //整批的键都已存在（批内还有重复），什么都不变
+    std::vector<std::pair<int, int> > same;
+    for (int i = 0; i < 300; ++i)
+        same.push_back(std::make_pair(i % 100 * 2, -1));
+    m.insert(same.begin(), same.end());
+    EXPECT_EQ(100u,m.size());
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(i,m[i * 2]);
+
+    //整批落在已有元素之前、之后，和已有元素交错且部分重复
+    std::vector<std::pair<int, int> > before, after, mixed;
+    for (int i = 0; i < 50; ++i) {
+        before.push_back(std::make_pair(-1 - i, -1));
+        after.push_back(std::make_pair(1000 + i, -1));
+        mixed.push_back(std::make_pair(i * 3, -1));  // 3的倍数，偶数的已存在
+    }
+    std::map<int, int> ref(m.begin(), m.end());
+    ref.insert(before.begin(), before.end());
+    ref.insert(after.begin(), after.end());
+    ref.insert(mixed.begin(), mixed.end());
+    m.insert(after.begin(), after.end());
+    m.insert(before.begin(), before.end());
+    m.insert(mixed.rbegin(), mixed.rend());
+    EXPECT_EQ(ref.size(),m.size());
+    std::map<int, int>::iterator r = ref.begin();
+    for (flat_map<int, int>::iterator it = m.begin(); it != m.end(); ++it, ++r)
+        EXPECT_TRUE(it->first == r->first && it->second == r->second);
+    EXPECT_EQ(0,m[0]);
+    EXPECT_EQ(-1,m[3]);
+    EXPECT_EQ(3,m[6]);
+
+    flat_map<int, int> empty;
+    empty.insert(same.begin(), same.begin());  //空批
+    EXPECT_TRUE(empty.empty());
+    m.insert(same.begin(), same.begin());
+    EXPECT_EQ(ref.size(),m.size());
+
+    flat_set<int> s;
+    s.insert(10);
+    s.insert(30);
+    EXPECT_EQ(20,*s.insert(s.find(30), 20));  //提示位置正确，不再查找
+    EXPECT_EQ(40,*s.insert(s.begin(), 40));    //提示错误时照常查找
+    EXPECT_EQ(4u,s.size());
+    EXPECT_EQ(40,*s.rbegin());
+}
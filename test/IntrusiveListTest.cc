@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "../IntrusiveList.h"
+
+using namespace TinySTL;
+
+struct Timer {
+    int id;
+    list_hook hook;
+};
+
+TEST(IntrusiveListTest,testLink){
+    Timer t[4];
+    intrusive_list<Timer, &Timer::hook> a, b;
+    for (int i = 0; i < 4; ++i) {
+        t[i].id = i;
+        a.push_back(t[i]);
+    }
+    EXPECT_EQ(4u,a.size());
+
+    a.remove(t[1]);
+    b.splice(b.end(), a, a.iterator_to(t[2]));
+    EXPECT_EQ(2u,a.size());
+    EXPECT_EQ(1u,b.size());
+    EXPECT_EQ(0,a.front().id);
+    EXPECT_EQ(3,a.back().id);
+    EXPECT_EQ(2,b.front().id);
+
+    a.push_front(t[1]);
+    EXPECT_EQ(1,a.front().id);
+}
+
+TEST(IntrusiveListTest,testSwap){
+    Timer t[2];
+    intrusive_list<Timer, &Timer::hook> a, b;
+    t[0].id = 0;
+    t[1].id = 1;
+    a.push_back(t[0]);
+    b.push_back(t[1]);
+    a.swap(b);
+
+    EXPECT_EQ(1,a.front().id);
+    EXPECT_EQ(0,b.front().id);
+    EXPECT_TRUE(++a.begin() == a.end());
+}
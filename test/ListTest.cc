@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
 #include "../List.h"
 
 using namespace TinySTL;
@@ -10,3 +12,134 @@ TEST(ListTest,testPush_back){
     EXPECT_EQ(1,v.front());
 }
 
+
+struct CountingAlloc {
+    static int count;
+    static void* allocate(size_t n) { ++count; return malloc(n); }
+    static void deallocate(void* p, size_t) { free(p); }
+};
+int CountingAlloc::count = 0;
+
+TEST(ListTest,testSortNoAllocation){
+    list<int, CountingAlloc> v;
+    EXPECT_EQ(0,CountingAlloc::count);
+    for (int i = 0; i < 100; ++i) v.push_back((i * 37) % 100);
+    CountingAlloc::count = 0;
+    v.sort();
+    EXPECT_EQ(0,CountingAlloc::count);
+
+    int expect = 0;
+    for (list<int, CountingAlloc>::iterator it = v.begin(); it != v.end(); ++it)
+        EXPECT_EQ(expect++,*it);
+}
+
+TEST(ListTest,testSwap){
+    list<int> a, b;
+    a.push_back(1);
+    a.push_back(2);
+    a.swap(b);
+
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(1,b.front());
+    EXPECT_EQ(2,b.back());
+}
+
+TEST(ListTest,testSize){
+    list<int> a, b;
+    for (int i = 0; i < 10; ++i) a.push_back(i % 5);
+    EXPECT_EQ(10u,a.size());
+
+    a.remove(0);
+    EXPECT_EQ(8u,a.size());
+    a.sort();
+    a.unique();
+    EXPECT_EQ(4u,a.size());
+
+    list<int>::iterator first = a.begin();
+    list<int>::iterator last = first;
+    ++last;
+    ++last;
+    b.splice(b.end(), a, first, last);
+    EXPECT_EQ(2u,a.size());
+    EXPECT_EQ(2u,b.size());
+
+    b.splice(b.end(), a, a.begin(), a.end(), 2);
+    b.merge(a);
+    EXPECT_EQ(0u,a.size());
+    EXPECT_EQ(4u,b.size());
+    b.merge(b);
+    EXPECT_EQ(4u,b.size());
+    EXPECT_EQ(4,TinySTL::distance(b.begin(), b.end()));
+
+    b.resize(1);
+    EXPECT_EQ(1u,b.size());
+    EXPECT_EQ(1,b.back());
+}
+
+TEST(ListTest,testSortLarge){
+    list<int> v;
+    for (int i = 0; i < 20000; ++i) v.push_back((i * 7919) % 20000);
+    v.sort();
+
+    EXPECT_EQ(20000u,v.size());
+    int expect = 0;
+    for (list<int>::iterator it = v.begin(); it != v.end(); ++it)
+        EXPECT_EQ(expect++,*it);
+    EXPECT_EQ(19999,*(--v.end()));
+}
+
+TEST(ListTest,testSortLargeStrings){
+    //非POD元素走按节点指针排序的路径
+    list<std::string> v;
+    for (int i = 0; i < 20000; ++i)
+        v.push_back(std::to_string((i * 7919) % 20000));
+    v.sort();
+    EXPECT_EQ(20000u,v.size());
+    list<std::string>::iterator prev = v.begin(), it = prev;
+    for (++it; it != v.end(); prev = it++) EXPECT_TRUE(*prev < *it);
+    EXPECT_EQ("0",v.front());
+    EXPECT_EQ("9999",*(--v.end()));
+}
+
+struct LiveAlloc {
+    static int live;
+    static void* allocate(size_t n) { ++live; return malloc(n); }
+    static void deallocate(void* p, size_t) { --live; free(p); }
+};
+int LiveAlloc::live = 0;
+
+//第fail_after次比较时抛出异常
+struct throwing_less {
+    static int fail_after;
+    int v;
+    bool operator<(const throwing_less& x) const {
+        if (fail_after >= 0 && fail_after-- == 0)
+            throw std::runtime_error("compare");
+        return v < x.v;
+    }
+};
+int throwing_less::fail_after = -1;
+
+TEST(ListTest,testSortThrow){
+    //比较抛出异常时排序用的缓冲区要释放，链表保持原样
+    {
+        list<throwing_less, LiveAlloc> v;
+        for (int i = 0; i < 5000; ++i) {
+            throwing_less x = {(i * 7919) % 5000};
+            v.push_back(x);
+        }
+        int live = LiveAlloc::live;
+        throwing_less::fail_after = 20000;
+        EXPECT_THROW(v.sort(),std::runtime_error);
+        throwing_less::fail_after = -1;
+        EXPECT_EQ(live,LiveAlloc::live);
+        EXPECT_EQ(5000u,v.size());
+        EXPECT_EQ(0,v.front().v);  //原来的顺序
+        v.sort();
+        int expect = 0;
+        for (list<throwing_less, LiveAlloc>::iterator it = v.begin();
+             it != v.end(); ++it)
+            EXPECT_EQ(expect++,it->v);
+    }
+    EXPECT_EQ(0,LiveAlloc::live);
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Map.h"
+
+using namespace TinySTL;
+
+typedef rb_tree<int, int, identity<int>, std::less<int> > int_tree;
+typedef rb_tree<int, int, identity<int>, std::less<int>, alloc,
+                __rb_tree_rank_node_base>
+    ranked_tree;
+
+TEST(MapTest,testInsertHint){
+    //提示正确时直接挂在提示位置旁边，错误时退回普通插入，结果都一样
+    int_tree u, e;
+    std::set<int> uref;
+    std::multiset<int> eref;
+    for (int i = 0; i < 500; ++i) {  //顺序插入以end()为提示
+        u.insert_unique(u.end(), i * 2);
+        e.insert_equal(e.end(), i * 2);
+        uref.insert(i * 2);
+        eref.insert(i * 2);
+    }
+    for (int i = 0; i < 500; ++i) {  //提示后继，-i提示begin()
+        u.insert_unique(u.find(i * 2), i * 2 - 1);
+        e.insert_equal(e.lower_bound(i * 2), i * 2);
+        u.insert_unique(u.begin(), -i);
+        e.insert_equal(e.begin(), -i);
+        uref.insert(i * 2 - 1);
+        uref.insert(-i);
+        eref.insert(i * 2);
+        eref.insert(-i);
+    }
+    srand(3);
+    for (int i = 0; i < 500; ++i) {  //提示随机，多半是错的
+        int k = rand() % 2000 - 500;
+        EXPECT_EQ(k,*u.insert_unique(u.lower_bound(rand() % 2000 - 500), k));
+        EXPECT_EQ(k,*e.insert_equal(e.lower_bound(rand() % 2000 - 500), k));
+        uref.insert(k);
+        eref.insert(k);
+    }
+    EXPECT_TRUE(u.__rb_verify());
+    EXPECT_TRUE(e.__rb_verify());
+    EXPECT_EQ(uref.size(),u.size());
+    EXPECT_EQ(eref.size(),e.size());
+    EXPECT_TRUE(std::equal(uref.begin(), uref.end(), u.begin()));
+    EXPECT_TRUE(std::equal(eref.begin(), eref.end(), e.begin()));
+}
+
+TEST(MapTest,testSortedBuild){
+    //已排序的区间一次建成平衡树，红黑性质要成立
+    for (int n = 0; n < 200; ++n) {
+        std::vector<int> v;
+        for (int i = 0; i < n; ++i) v.push_back(i / 2);  //每个键出现两次
+        int_tree unique, equal;
+        unique.insert_unique(v.begin(), v.end());
+        equal.insert_equal(v.begin(), v.end());
+        EXPECT_TRUE(unique.__rb_verify());
+        EXPECT_TRUE(equal.__rb_verify());
+        EXPECT_EQ(size_t((n + 1) / 2),unique.size());
+        EXPECT_EQ(size_t(n),equal.size());
+        if (n > 0) EXPECT_EQ(size_t(2 - n % 2),equal.count(v.back()));
+        unique.insert_unique(n);  //建好的树可以继续正常插入删除
+        unique.erase(0);
+        EXPECT_TRUE(unique.__rb_verify());
+    }
+
+    std::vector<std::pair<int, std::string> > kv;
+    for (int i = 0; i < 1000; ++i)
+        kv.push_back(std::make_pair(i, std::to_string(i)));
+    map<int, std::string> m(kv.begin(), kv.end());
+    EXPECT_EQ(1000u,m.size());
+    EXPECT_EQ("999",m.find(999)->second);
+
+    kv[10].first = 5000;  //无序的输入退回逐个插入
+    map<int, std::string> u(kv.begin(), kv.end());
+    EXPECT_EQ(1000u,u.size());
+    EXPECT_EQ("10",u.find(5000)->second);
+}
+
+//第copies_left次之后的复制抛出异常，live是存活的对象数
+struct live_counted {
+    static int live, copies_left;
+    int k;
+    explicit live_counted(int k) : k(k) { ++live; }
+    live_counted(const live_counted& x) : k(x.k) {
+        if (copies_left-- == 0) throw std::runtime_error("copy");
+        ++live;
+    }
+    ~live_counted() { --live; }
+};
+int live_counted::live = 0, live_counted::copies_left = 0;
+
+struct live_counted_key {
+    const int& operator()(const live_counted& x) const { return x.k; }
+};
+
+TEST(MapTest,testSortedBuildThrow){
+    //建树中途复制失败，已经建好的子树都要释放，树保持为空
+    typedef rb_tree<int, live_counted, live_counted_key, std::less<int> >
+        counted_tree;
+    live_counted::copies_left = 1000;
+    std::vector<live_counted> v;
+    v.reserve(100);
+    for (int i = 0; i < 100; ++i) v.push_back(live_counted(i));
+    for (int k = 0; k < 100; k += 7) {
+        counted_tree t;
+        live_counted::copies_left = k;
+        EXPECT_THROW(t.insert_equal(v.begin(), v.end()),std::runtime_error);
+        EXPECT_EQ(100,live_counted::live);
+        EXPECT_EQ(0u,t.size());
+        EXPECT_TRUE(t.__rb_verify());
+    }
+    live_counted::copies_left = 1000;
+    counted_tree t;
+    t.insert_equal(v.begin(), v.end());
+    EXPECT_EQ(200,live_counted::live);
+    EXPECT_TRUE(t.__rb_verify());
+}
+
+TEST(MapTest,testOrderStatistics){
+    //随机插入删除，子树大小要和中序位置一致
+    ranked_tree t;
+    std::vector<int> keys;
+    for (int i = 0; i < 2000; ++i) {
+        int k = (i * 7919) % 1000;
+        if (t.count(k) && i % 3 == 0)
+            t.erase(k);
+        else
+            t.insert_equal(k);
+    }
+    EXPECT_TRUE(t.__rb_verify());
+    for (ranked_tree::iterator it = t.begin(); it != t.end(); ++it)
+        keys.push_back(*it);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(keys[i],*t.select(i));
+        EXPECT_EQ(i,t.index_of(t.select(i)));
+    }
+    EXPECT_TRUE(t.select(keys.size()) == t.end());
+    EXPECT_EQ(size_t(std::lower_bound(keys.begin(), keys.end(), 500) -
+                     keys.begin()),t.rank(500));
+    ranked_tree c(t);
+    EXPECT_TRUE(c.__rb_verify());
+
+    ranked_map<int, std::string> m;
+    for (int i = 0; i < 100; ++i) m[i * 10] = std::to_string(i);
+    EXPECT_EQ(420,m.select(42)->first);
+    EXPECT_EQ(43u,m.rank(425));
+    EXPECT_EQ(100,m.distance(m.begin(), m.end()));
+    EXPECT_EQ(5,m.distance(m.find(100), m.find(150)));
+    m.erase(m.find(120), m.find(140));
+    EXPECT_EQ(3,m.distance(m.find(100), m.find(150)));
+}
+
+//搬动元素时只摘下和挂上节点，元素的地址不变，也不会被复制
+struct copy_counted {
+    static int copies;
+    std::string s;
+    explicit copy_counted(const std::string& x) : s(x) {}
+    copy_counted(const copy_counted& x) : s(x.s) { ++copies; }
+};
+int copy_counted::copies = 0;
+
+TEST(MapTest,testNodeHandle){
+    typedef map<int, copy_counted> counted_map;
+    counted_map a, b;
+    for (int i = 0; i < 10; ++i)
+        a.insert(std::make_pair(i, copy_counted(std::to_string(i))));
+    b.insert(std::make_pair(3, copy_counted("b3")));
+    map<int, copy_counted, std::greater<int> > c;
+    c.insert(std::make_pair(7, copy_counted("c7")));
+    copy_counted::copies = 0;
+
+    const counted_map::value_type* p = &*a.find(5);
+    counted_map::node_type nh = a.extract(5);
+    EXPECT_FALSE(nh.empty());
+    EXPECT_EQ(0u,a.count(5));
+    EXPECT_EQ(p,&nh.value());
+    nh.value().second.s = "moved";
+    EXPECT_TRUE(b.insert(std::move(nh)).second);
+    EXPECT_TRUE(nh.empty());
+    EXPECT_EQ(p,&*b.find(5));
+    EXPECT_EQ("moved",b.find(5)->second.s);
+
+    //键冲突时节点留在句柄中
+    nh = a.extract(a.find(3));
+    EXPECT_FALSE(b.insert(std::move(nh)).second);
+    EXPECT_EQ("3",nh.value().second.s);
+    EXPECT_TRUE(a.extract(100).empty());
+
+    c.merge(a);  //已有的7留在a中
+    EXPECT_EQ(1u,a.size());
+    EXPECT_EQ(7,a.begin()->first);
+    EXPECT_EQ(8u,c.size());
+    EXPECT_EQ(9,c.begin()->first);
+    EXPECT_EQ(0,copy_counted::copies);
+}
+
+//按id排序的记录，比较器可以直接拿id和记录比较
+struct record {
+    int id;
+    std::string name;
+    bool operator<(const record& x) const { return id < x.id; }
+};
+struct record_less {
+    typedef void is_transparent;
+    bool operator()(const record& x, const record& y) const {
+        return x.id < y.id;
+    }
+    bool operator()(const record& x, int id) const { return x.id < id; }
+    bool operator()(int id, const record& x) const { return id < x.id; }
+};
+
+TEST(MapTest,testTransparentLookup){
+    map<std::string, int, transparent_less> m;
+    const char* words[] = {"apple", "banana", "cherry", "date"};
+    for (int i = 0; i < 4; ++i) m.insert(std::make_pair(words[i], i));
+    EXPECT_EQ(1,m.find("banana")->second);  //不构造std::string
+    EXPECT_TRUE(m.find("fig") == m.end());
+    EXPECT_EQ(1u,m.count("date"));
+    EXPECT_EQ("cherry",m.lower_bound("c")->first);
+    EXPECT_EQ("cherry",m.upper_bound("banana")->first);
+    EXPECT_EQ(1,TinySTL::distance(m.equal_range("apple").first,
+                                  m.equal_range("apple").second));
+    EXPECT_EQ(2,m.find(std::string("cherry"))->second);
+
+    map<record, std::string, record_less> r;
+    for (int i = 0; i < 10; ++i) {
+        record x = {i * 10, std::to_string(i)};
+        r.insert(std::make_pair(x, x.name));
+    }
+    EXPECT_EQ("3",r.find(30)->second);
+    EXPECT_EQ(40,r.lower_bound(31)->first.id);
+    EXPECT_EQ(0u,r.count(31));
+    const map<record, std::string, record_less>& cr = r;
+    EXPECT_EQ(90,cr.upper_bound(89)->first.id);
+}
+
+//元素只在真正插入时原地构造一次，键已存在时什么都不构造
+struct ctor_counted {
+    static int ctors;
+    int v;
+    ctor_counted() : v(0) { ++ctors; }
+    explicit ctor_counted(int a) : v(a) { ++ctors; }
+    ctor_counted(int a, int b) : v(a + b) { ++ctors; }
+    ctor_counted(const ctor_counted& x) : v(x.v) { ++ctors; }
+    ctor_counted& operator=(int x) { v = x; return *this; }
+};
+int ctor_counted::ctors = 0;
+
+TEST(MapTest,testEmplace){
+    map<int, ctor_counted> m;
+    EXPECT_TRUE(m.try_emplace(1, 2, 3).second);
+    EXPECT_EQ(1,ctor_counted::ctors);
+    EXPECT_FALSE(m.try_emplace(1, 4, 5).second);
+    EXPECT_EQ(5,m[1].v);
+    m[1] = 7;
+    EXPECT_EQ(1,ctor_counted::ctors);  // operator[]命中时不构造T()
+    m[2];
+    EXPECT_EQ(2,ctor_counted::ctors);
+    EXPECT_EQ(0,m.find(2)->second.v);
+
+    EXPECT_FALSE(m.insert_or_assign(2, 9).second);
+    EXPECT_EQ(9,m[2].v);
+    EXPECT_EQ(3,m.try_emplace(m.end(), 3, 1, 2)->second.v);
+    EXPECT_EQ(3,ctor_counted::ctors);
+
+    map<std::string, std::string> s;
+    std::string value("value");
+    s.try_emplace("k", std::move(value));
+    EXPECT_FALSE(s.try_emplace("k", std::move(value)).second);
+    EXPECT_EQ("",value);
+    value = "kept";
+    EXPECT_FALSE(s.try_emplace("k", std::move(value)).second);
+    EXPECT_EQ("kept",value);  //没插入时不移走参数
+    EXPECT_TRUE(s.emplace("a", "1").second);
+    EXPECT_FALSE(s.emplace("a", "2").second);
+    EXPECT_EQ("1",s["a"]);
+    EXPECT_EQ("b",s.emplace_hint(s.end(), "b", "2")->first);
+    EXPECT_TRUE(s.insert_or_assign(s.begin(), "c", "3")->second == "3");
+    s.insert_or_assign("a", std::string("x"));
+    EXPECT_EQ("x",s["a"]);
+    EXPECT_EQ(4u,s.size());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../PersistentMap.h"
+
+using namespace TinySTL;
+
+typedef persistent_map<int, std::string> string_map;
+
+TEST(PersistentMapTest,testSnapshot){
+    //从两头往中间插入，旋转不断复制路径；每10次留一个快照，
+    //后面的插入不能改动已经留下的版本
+    string_map m;
+    std::vector<string_map> snapshots;
+    for (int i = 0; i < 100; ++i) {
+        int k = i % 2 ? 99 - i / 2 : i / 2;
+        m.insert(string_map::value_type(k, std::to_string(k)));
+        if (i % 10 == 9) snapshots.push_back(m);
+    }
+    for (size_t v = 0; v < snapshots.size(); ++v) {
+        ASSERT_TRUE(snapshots[v].__pmap_verify());
+        EXPECT_EQ(v * 10 + 10,snapshots[v].size());
+        EXPECT_EQ(1u,snapshots[v].count(int(v * 5 + 4)));
+        if (v + 1 < snapshots.size())
+            EXPECT_EQ(0u,snapshots[v].count(int(v * 5 + 5)));
+    }
+    string_map v1(m);  //快照
+    EXPECT_TRUE(v1 == m);
+
+    EXPECT_FALSE(m.insert(string_map::value_type(0, "x")).second);
+    EXPECT_FALSE(m.insert_or_assign(37, "x").second);
+    EXPECT_EQ(1u,m.erase(50));
+    m.insert(string_map::value_type(100, "100"));
+    EXPECT_TRUE(m.__pmap_verify());
+
+    //旧版本不受影响
+    EXPECT_EQ(100u,v1.size());
+    EXPECT_EQ("37",v1.find(37)->second);
+    EXPECT_EQ(1u,v1.count(50));
+    EXPECT_TRUE(v1.find(100) == v1.end());
+    EXPECT_EQ("x",m.find(37)->second);
+    EXPECT_EQ(0u,m.count(50));
+    EXPECT_TRUE(v1 < m);
+
+    int expect = 0;
+    for (string_map::const_iterator it = v1.begin(); it != v1.end(); ++it)
+        EXPECT_EQ(expect++,it->first);
+    expect = 100;
+    for (string_map::const_reverse_iterator it = m.rbegin(); it != m.rend();
+         ++it, --expect) {
+        if (expect == 50) --expect;
+        EXPECT_EQ(expect,it->first);
+    }
+    EXPECT_EQ(51,m.lower_bound(50)->first);
+    EXPECT_EQ(52,m.upper_bound(51)->first);
+    EXPECT_TRUE(m.upper_bound(100) == m.end());
+}
+
+TEST(PersistentMapTest,testVersions){
+    persistent_map<int, int> m;
+    std::map<int, int> ref;
+    std::vector<std::pair<persistent_map<int, int>, std::map<int, int> > >
+        versions;
+    srand(5);
+    for (int i = 0; i < 5000; ++i) {
+        int k = rand() % 500;
+        if (rand() % 3)
+            m.insert_or_assign(k, i), ref[k] = i;
+        else
+            EXPECT_EQ(ref.erase(k),m.erase(k));
+        if (i % 500 == 0) versions.push_back(std::make_pair(m, ref));
+    }
+    ASSERT_TRUE(m.__pmap_verify());
+    versions.push_back(std::make_pair(m, ref));
+    m.clear();
+    for (size_t v = 0; v < versions.size(); ++v) {
+        const persistent_map<int, int>& s = versions[v].first;
+        const std::map<int, int>& r = versions[v].second;
+        ASSERT_TRUE(s.__pmap_verify());
+        ASSERT_EQ(r.size(),s.size());
+        std::map<int, int>::const_iterator j = r.begin();
+        for (persistent_map<int, int>::const_iterator it = s.begin();
+             it != s.end(); ++it, ++j)
+            EXPECT_TRUE(it->first == j->first && it->second == j->second);
+    }
+}
+
+//读者遍历自己的快照，写者同时修改并不断释放旧版本
+TEST(PersistentMapTest,testConcurrentReaders){
+    persistent_map<int, int> m;
+    for (int i = 0; i < 1000; ++i) m.insert(std::make_pair(i, i));
+    std::vector<persistent_map<int, int> > snaps(4, m);
+    std::vector<std::thread> readers;
+    std::vector<long> sums(snaps.size(), 0);
+    for (size_t r = 0; r < snaps.size(); ++r)
+        readers.push_back(std::thread([&snaps, &sums, r]() {
+            for (int round = 0; round < 50; ++round)
+                for (persistent_map<int, int>::const_iterator it =
+                         snaps[r].begin();
+                     it != snaps[r].end(); ++it)
+                    sums[r] += it->second;
+            snaps[r].clear();
+        }));
+    for (int i = 0; i < 20000; ++i) {
+        m.insert_or_assign(i % 1000, -i);
+        if (i % 7 == 0) m.erase(i % 1000);
+    }
+    for (size_t r = 0; r < readers.size(); ++r) {
+        readers[r].join();
+        EXPECT_EQ(50L * 999 * 1000 / 2,sums[r]);
+    }
+    EXPECT_TRUE(m.__pmap_verify());
+}
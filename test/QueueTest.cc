@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "../Queue.h"
+
+using namespace TinySTL;
+
+TEST(QueueTest,testAdaptor){
+    queue<int> q, r;
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    EXPECT_EQ(1000u,q.size());
+    EXPECT_EQ(0,q.front());
+    EXPECT_EQ(999,q.back());
+    for (int i = 0; i < 500; ++i) q.pop();
+    EXPECT_EQ(500,q.front());
+
+    for (int i = 500; i < 1000; ++i) r.push(i);
+    EXPECT_TRUE(q == r);
+    r.pop();
+    EXPECT_TRUE(q < r);
+}
+
+TEST(QueueTest,testSpscBatch){
+    spsc_queue<std::string> q(5);
+    EXPECT_EQ(8u,q.capacity());
+    std::string in[10], out[10];
+    for (int i = 0; i < 10; ++i) in[i] = std::to_string(i);
+
+    EXPECT_EQ(8u,q.push_n(in, 10));
+    EXPECT_FALSE(q.try_push(in[0]));
+    EXPECT_EQ(3u,q.pop_n(out, 3));
+    EXPECT_EQ("2",out[2]);
+    EXPECT_EQ(2u,q.push_n(in + 8, 2));
+    EXPECT_EQ(7u,q.pop_n(out, 10));
+    EXPECT_EQ("3",out[0]);
+    EXPECT_EQ("9",out[6]);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(QueueTest,testSpscThreads){
+    const long n = 1000000;
+    spsc_queue<long> q(1024);
+    std::thread producer([&] {
+        for (long i = 0; i < n; ++i)
+            while (!q.try_push(i)) std::this_thread::yield();
+    });
+    long expect = 0, x;
+    bool ordered = true;
+    while (expect < n)
+        if (q.try_pop(x))
+            ordered &= (x == expect++);
+        else
+            std::this_thread::yield();
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(QueueTest,testMpmcTimed){
+    mpmc_queue<std::string> q(2);
+    EXPECT_TRUE(q.try_push("a"));
+    q.push("b");
+    EXPECT_FALSE(q.try_push("c"));
+    EXPECT_FALSE(q.try_push_for("c", std::chrono::milliseconds(5)));
+
+    std::string x;
+    q.pop(x);
+    EXPECT_EQ("a",x);
+    EXPECT_TRUE(q.try_pop_for(x, std::chrono::milliseconds(5)));
+    EXPECT_EQ("b",x);
+    EXPECT_FALSE(q.try_pop_for(x, std::chrono::milliseconds(5)));
+    q.push("left for the destructor");
+}
+
+//复制按要求抛出异常，移动不抛出
+struct throwing_copy {
+    static bool fail;
+    int v;
+    explicit throwing_copy(int v = 0) : v(v) {}
+    throwing_copy(const throwing_copy& x) : v(x.v) {
+        if (fail) throw std::runtime_error("copy");
+    }
+    throwing_copy(throwing_copy&& x) noexcept : v(x.v) {}
+    throwing_copy& operator=(throwing_copy&& x) noexcept {
+        v = x.v;
+        return *this;
+    }
+};
+bool throwing_copy::fail = false;
+
+TEST(QueueTest,testMpmcThrowingCopy){
+    //复制失败时还没有领取下标，后面的pop不会等在空槽位上
+    mpmc_queue<throwing_copy> q(4);
+    throwing_copy a(1), b(2);
+    throwing_copy::fail = true;
+    EXPECT_THROW(q.push(a),std::runtime_error);
+    EXPECT_THROW(q.try_push(a),std::runtime_error);
+    EXPECT_TRUE(q.empty());
+    q.push(std::move(b));  //右值直接移入槽位
+    EXPECT_TRUE(q.try_push(throwing_copy(3)));
+    throwing_copy::fail = false;
+    q.push(a);
+    throwing_copy x;
+    q.pop(x);
+    EXPECT_EQ(2,x.v);
+    EXPECT_TRUE(q.try_pop(x));
+    EXPECT_EQ(3,x.v);
+    EXPECT_TRUE(q.try_pop_for(x, std::chrono::milliseconds(5)));
+    EXPECT_EQ(1,x.v);
+    EXPECT_FALSE(q.try_pop(x));
+}
+
+TEST(QueueTest,testMpmcThreads){
+    const int threads = 4, n = 100000;
+    mpmc_queue<long> q(64);
+    std::atomic<long> sum(0);
+    std::thread producers[threads], consumers[threads];
+    for (int t = 0; t < threads; ++t) {
+        producers[t] = std::thread([&q, t] {
+            for (long i = 0; i < n; ++i) {
+                if (i & 1)
+                    q.push(i);
+                else
+                    while (!q.try_push(i)) std::this_thread::yield();
+            }
+        });
+        consumers[t] = std::thread([&q, &sum, t] {
+            long x, local = 0;
+            for (long i = 0; i < n; ++i) {
+                if (t & 1)
+                    q.pop(x);
+                else
+                    while (!q.try_pop(x)) std::this_thread::yield();
+                local += x;
+            }
+            sum += local;
+        });
+    }
+    for (int t = 0; t < threads; ++t) {
+        producers[t].join();
+        consumers[t].join();
+    }
+    EXPECT_EQ((long)threads * n * (n - 1) / 2,sum.load());
+    EXPECT_TRUE(q.empty());
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../Set.h"
+
+using namespace TinySTL;
+
+typedef rb_tree<int, int, identity<int>, std::less<int> > int_tree;
+typedef rb_tree<int, int, identity<int>, std::less<int>, alloc,
+                __rb_tree_rank_node_base>
+    ranked_tree;
+
+TEST(SetTest,testInsertErase){
+    set<int> s;
+    for (int i = 0; i < 1000; ++i) s.insert(rand() % 100);
+    EXPECT_EQ(100u,s.size());
+    EXPECT_FALSE(s.insert(5).second);
+    int expect = 0;
+    for (set<int>::iterator it = s.begin(); it != s.end(); ++it)
+        EXPECT_EQ(expect++,*it);
+    s.erase(s.find(5));
+    EXPECT_EQ(0u,s.count(5));
+    EXPECT_EQ(6,*s.upper_bound(4));
+}
+
+TEST(SetTest,testRangeConstruct){
+    int sorted[] = {1, 2, 2, 3, 5, 8, 8, 8, 13};
+    int shuffled[] = {8, 3, 13, 1, 8, 2, 5};
+    set<int> a(sorted, sorted + 9), b(shuffled, shuffled + 7);
+    EXPECT_EQ(6u,a.size());
+    EXPECT_TRUE(a == b);
+    b.erase(13);
+    EXPECT_TRUE(b < a);
+}
+
+TEST(SetTest,testRank){
+    ranked_set<int> s;
+    for (int i = 0; i < 1000; ++i) s.insert((i * 37) % 1000);
+    for (int i = 0; i < 1000; i += 2) s.erase(i);
+    EXPECT_EQ(500u,s.size());
+    EXPECT_EQ(201,*s.select(100));
+    EXPECT_EQ(100u,s.rank(201));
+    EXPECT_EQ(101u,s.rank(202));
+    EXPECT_TRUE(s.select(500) == s.end());
+    EXPECT_EQ(250,s.distance(s.begin(), s.find(501)));
+}
+
+TEST(SetTest,testMerge){
+    set<int> a, b;
+    for (int i = 0; i < 100; ++i) a.insert(i * 2);
+    for (int i = 0; i < 100; ++i) b.insert(i * 3);
+    a.merge(b);
+    EXPECT_EQ(166u,a.size());  //交集中的34个留在b中
+    EXPECT_EQ(34u,b.size());
+    for (set<int>::iterator it = b.begin(); it != b.end(); ++it)
+        EXPECT_EQ(0,*it % 6);
+    set<int>::node_type nh = a.extract(a.begin());
+    EXPECT_EQ(0,nh.value());
+    EXPECT_FALSE(b.insert(std::move(nh)).second);
+    nh = a.extract(3);
+    EXPECT_TRUE(a.insert(std::move(nh)).second);
+    EXPECT_EQ(165u,a.size());  // 0的节点随句柄重新赋值而释放
+}
+
+TEST(SetTest,testSplitJoin){
+    ranked_set<int> a, b;
+    for (int i = 0; i < 1000; ++i) a.insert(i);
+    a.split(600, b);
+    EXPECT_EQ(600u,a.size());
+    EXPECT_EQ(400u,b.size());
+    EXPECT_EQ(599,*a.rbegin());
+    EXPECT_EQ(600,*b.begin());
+    EXPECT_EQ(100u,b.rank(700));  //子树大小随分裂一起维护
+
+    set<int> c, d;
+    for (int i = 0; i < 100; ++i) c.insert(i);
+    d.insert(-1);
+    c.split(c.find(30), d);  // d原有的元素被清除
+    EXPECT_EQ(30u,c.size());
+    EXPECT_EQ(70u,d.size());
+    d.erase(d.find(40), d.find(90));  //短区间逐个删除
+    EXPECT_EQ(20u,d.size());
+    c.join(d);
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(50u,c.size());
+    EXPECT_TRUE(c.find(40) == c.end());
+    EXPECT_EQ(90,*c.lower_bound(40));
+    EXPECT_EQ(0,*c.begin());
+    EXPECT_EQ(99,*c.rbegin());
+}
+
+TEST(SetTest,testSetAlgebra){
+    set<int> a, b, c;
+    for (int i = 0; i < 1000; ++i) a.insert(i * 2);
+    for (int i = 0; i < 1000; ++i) b.insert(i * 3);
+    c = a;
+    c.set_intersection(b);  //公倍数6
+    EXPECT_EQ(334u,c.size());
+    for (set<int>::iterator it = c.begin(); it != c.end(); ++it)
+        EXPECT_EQ(0,*it % 6);
+    set<int> d(a);
+    d.set_difference(b);
+    EXPECT_EQ(666u,d.size());
+    EXPECT_TRUE(d.find(6) == d.end());
+    EXPECT_TRUE(d.find(4) != d.end());
+    a.set_union(b);
+    EXPECT_EQ(1666u,a.size());
+    EXPECT_TRUE(b.empty());
+    a.set_difference(c);
+    a.set_union(c);
+    EXPECT_EQ(1666u,a.size());
+    EXPECT_EQ(2997,*a.rbegin());
+}
+
+//树中的元素与ref相同，__rb_verify同时检查带子树大小的树的size字段
+template <class Tree>
+bool same_as(const Tree& t, const std::multiset<int>& ref) {
+    return t.__rb_verify() && t.size() == ref.size() &&
+           std::equal(ref.begin(), ref.end(), t.begin());
+}
+
+template <class Tree>
+void check_range_erase() {
+    //超过1024个元素的区间分裂后整段销毁，再把两边连接起来
+    const int n = 6000;
+    const int ranges[][2] = {{0, 3000},   {4000, n},  {1000, 4500},
+                             {2000, 2100}, {10, 1500}, {0, n}};
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+        Tree t;
+        std::multiset<int> ref;
+        for (int i = 0; i < n; ++i) {  //每个键两次，分裂点落在重复键中间
+            t.insert_equal(i / 2);
+            ref.insert(i / 2);
+        }
+        int first = ranges[r][0], last = ranges[r][1];
+        typename Tree::iterator f = t.begin(), l = t.begin();
+        std::multiset<int>::iterator rf = ref.begin(), rl = ref.begin();
+        TinySTL::advance(f, first);
+        TinySTL::advance(l, last);
+        std::advance(rf, first);
+        std::advance(rl, last);
+        t.erase(f, l);
+        ref.erase(rf, rl);
+        EXPECT_TRUE(same_as(t, ref));
+        t.insert_equal(n / 4);  //连接出来的树可以继续插入删除
+        ref.insert(n / 4);
+        t.erase(t.begin());
+        ref.erase(ref.begin());
+        EXPECT_TRUE(same_as(t, ref));
+    }
+}
+
+TEST(SetTest,testTreeRangeErase){
+    check_range_erase<int_tree>();
+    check_range_erase<ranked_tree>();
+}
+
+template <class Tree>
+void fill(Tree& t, std::multiset<int>& ref, int n, int step, int offset) {
+    for (int i = 0; i < n; ++i) {
+        t.insert_unique(offset + i * step);
+        ref.insert(offset + i * step);
+    }
+}
+
+template <class Tree>
+void check_split_join_algebra() {
+    for (int k = -1; k <= 3001; k += 250) {  //包括两端之外的分裂点
+        Tree t, right;
+        std::multiset<int> ref;
+        fill(t, ref, 3000, 1, 0);
+        right.insert_unique(-5);
+        t.split(k, right);
+        std::multiset<int> lref(ref.begin(), ref.lower_bound(k)),
+            rref(ref.lower_bound(k), ref.end());
+        EXPECT_TRUE(same_as(t, lref));
+        EXPECT_TRUE(same_as(right, rref));
+        t.join(right);
+        EXPECT_TRUE(same_as(t, ref));
+        EXPECT_TRUE(same_as(right, std::multiset<int>()));
+    }
+
+    //大小相近和相差悬殊（逐个处理）的两种情况
+    const int sizes[][2] = {{2000, 1500}, {5000, 30}, {30, 5000}};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        Tree a, b;
+        std::multiset<int> ra, rb;
+        fill(a, ra, sizes[i][0], 2, 0);
+        fill(b, rb, sizes[i][1], 3, 1);
+        std::multiset<int> u, in, diff;
+        std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                       std::inserter(u, u.end()));
+        std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                              std::inserter(in, in.end()));
+        std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                            std::inserter(diff, diff.end()));
+        Tree c(a), d(a);
+        c.set_intersection(b);
+        EXPECT_TRUE(same_as(c, in));
+        d.set_difference(b);
+        EXPECT_TRUE(same_as(d, diff));
+        a.set_union(b);
+        EXPECT_TRUE(same_as(a, u));
+        EXPECT_TRUE(same_as(b, std::multiset<int>()));
+    }
+}
+
+TEST(SetTest,testTreeSplitJoinAlgebra){
+    check_split_join_algebra<int_tree>();
+    check_split_join_algebra<ranked_tree>();
+}
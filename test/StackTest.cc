@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "../Stack.h"
+#include "../Vector.h"
+
+using namespace TinySTL;
+
+TEST(StackTest,testAdaptor){
+    stack<int> s;
+    stack<int, vector<int> > v;
+    for (int i = 0; i < 1000; ++i) {
+        s.push(i);
+        v.push(i);
+    }
+    EXPECT_EQ(1000u,s.size());
+    EXPECT_EQ(1000u,v.size());
+    for (int i = 999; i >= 0; --i) {
+        EXPECT_EQ(i,s.top());
+        EXPECT_EQ(i,v.top());
+        s.pop();
+        v.pop();
+    }
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(StackTest,testLockFree){
+    lock_free_stack<std::string> s(3);
+    std::string x;
+    EXPECT_FALSE(s.try_pop(x));
+    EXPECT_TRUE(s.try_push("a"));
+    EXPECT_TRUE(s.try_push("b"));
+    EXPECT_TRUE(s.try_push("c"));
+    EXPECT_FALSE(s.try_push("d"));  //节点用完
+    EXPECT_TRUE(s.try_pop(x));
+    EXPECT_EQ("c",x);
+    EXPECT_TRUE(s.try_push("e"));
+    EXPECT_TRUE(s.try_pop(x));
+    EXPECT_EQ("e",x);
+    EXPECT_TRUE(s.try_pop(x));
+    EXPECT_EQ("b",x);
+    EXPECT_FALSE(s.empty());  //剩下的"a"由析构函数销毁
+}
+
+TEST(StackTest,testLockFreeThreads){
+    const int threads = 4, n = 100000;
+    lock_free_stack<long> s(64);
+    std::atomic<long> sum(0);
+    std::thread workers[threads];
+    for (int t = 0; t < threads; ++t) {
+        workers[t] = std::thread([&s, &sum] {
+            long x, local = 0;
+            for (long i = 0; i < n; ++i) {  //每个元素压入后由任意线程弹出
+                while (!s.try_push(i)) std::this_thread::yield();
+                while (!s.try_pop(x)) std::this_thread::yield();
+                local += x;
+            }
+            sum += local;
+        });
+    }
+    for (int t = 0; t < threads; ++t) workers[t].join();
+    EXPECT_EQ((long)threads * n * (n - 1) / 2,sum.load());
+    EXPECT_TRUE(s.empty());
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "../UnorderedMap.h"
+#include "../UnorderedSet.h"
+
+using namespace TinySTL;
+
+//所有键只落在3个哈希值上，探测序列很长，删除会留下已删除标记
+struct collide_hash {
+    size_t operator()(int k) const { return k % 3; }
+};
+
+typedef hashtable<int, int, identity<int>, std::hash<int>, std::equal_to<int> >
+    int_table;
+typedef hashtable<int, int, identity<int>, collide_hash, std::equal_to<int> >
+    collide_table;
+
+TEST(UnorderedMapTest,testSmallTables){
+    //容量小于一组时探测会绕回表头，读到的是末尾的控制字节副本；
+    //逐个长到几组大小，每一步所有键都要找得到
+    int_table t;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(t.insert_unique(i * 7).second);
+        ASSERT_TRUE(t.__hashtable_verify());
+        for (int j = 0; j <= i; ++j) EXPECT_EQ(1u,t.count(j * 7));
+        EXPECT_EQ(0u,t.count(i * 7 + 1));
+    }
+    //从大到小删空，删掉的找不到，剩下的都还在
+    for (int i = 99; i >= 0; --i) {
+        EXPECT_EQ(1u,t.erase(i * 7));
+        ASSERT_TRUE(t.__hashtable_verify());
+        EXPECT_EQ(0u,t.count(i * 7));
+        if (i > 0) EXPECT_EQ(1u,t.count((i - 1) * 7));
+    }
+    EXPECT_TRUE(t.begin() == t.end());
+}
+
+TEST(UnorderedMapTest,testTombstones){
+    //所有键探测同一条长序列，删除在序列中间留下已删除标记，
+    //查找必须越过它们继续找，插入可以重新占用
+    collide_table t;
+    for (int i = 0; i < 300; ++i) t.insert_unique(i);
+    for (int i = 0; i < 300; i += 2) EXPECT_EQ(1u,t.erase(i));
+    ASSERT_TRUE(t.__hashtable_verify());
+    for (int i = 0; i < 300; ++i) EXPECT_EQ(size_t(i % 2),t.count(i));
+    size_t buckets = t.bucket_count();
+    for (int i = 0; i < 300; i += 2) EXPECT_TRUE(t.insert_unique(i).second);
+    EXPECT_EQ(buckets,t.bucket_count());  //占回已删除的槽，不扩容
+    ASSERT_TRUE(t.__hashtable_verify());
+
+    //遍历中删除只让被删元素的迭代器失效，每个元素恰好访问一次
+    size_t visited = 0;
+    for (collide_table::iterator it = t.begin(); it != t.end(); ++visited)
+        if (*it % 3)
+            t.erase(it++);
+        else
+            ++it;
+    EXPECT_EQ(300u,visited);
+    EXPECT_EQ(100u,t.size());
+    ASSERT_TRUE(t.__hashtable_verify());
+    for (int i = 0; i < 300; ++i) EXPECT_EQ(size_t(i % 3 == 0),t.count(i));
+}
+
+//第fail_at次分配抛出bad_alloc，fail_at为0时不失败
+struct failing_alloc {
+    static int fail_at;
+    static void* allocate(size_t n) {
+        if (fail_at && --fail_at == 0) throw std::bad_alloc();
+        return malloc(n);
+    }
+    static void deallocate(void* p, size_t) { free(p); }
+};
+int failing_alloc::fail_at = 0;
+
+//复制时按要求抛出异常，扩容搬动元素时用到
+struct throwing_key {
+    static bool fail;
+    int k;
+    explicit throwing_key(int k) : k(k) {}
+    throwing_key(const throwing_key& x) : k(x.k) {
+        if (fail) throw std::runtime_error("copy");
+    }
+};
+bool throwing_key::fail = false;
+
+struct throwing_key_of {
+    const int& operator()(const throwing_key& x) const { return x.k; }
+};
+
+TEST(UnorderedMapTest,testGrowthFailure){
+    //扩容时控制字节或槽数组分配失败，表保持原样，之后还能正常扩容
+    typedef hashtable<int, int, identity<int>, std::hash<int>,
+                      std::equal_to<int>, failing_alloc>
+        alloc_table;
+    alloc_table t;
+    int failures = 0;
+    for (int i = 0; i < 200; ++i) {
+        failing_alloc::fail_at = 1 + i % 2;
+        try {
+            t.insert_unique(i);
+        }
+        catch (const std::bad_alloc&) {
+            ++failures;
+            failing_alloc::fail_at = 0;
+            ASSERT_TRUE(t.__hashtable_verify());
+            ASSERT_EQ(size_t(i),t.size());
+            t.insert_unique(i);
+        }
+        failing_alloc::fail_at = 0;
+        ASSERT_TRUE(t.__hashtable_verify());
+        for (int j = 0; j <= i; ++j) ASSERT_EQ(1u,t.count(j));
+    }
+    EXPECT_LT(0,failures);
+
+    //搬动元素时复制失败，余量也要恢复
+    typedef hashtable<int, throwing_key, throwing_key_of, std::hash<int>,
+                      std::equal_to<int> >
+        copy_table;
+    copy_table c;
+    for (int i = 0; i < 200; ++i) {
+        size_t buckets = c.bucket_count();
+        throwing_key::fail = true;
+        try {
+            c.insert_unique(throwing_key(i));  //不扩容时复制也会失败
+        }
+        catch (const std::runtime_error&) {
+            if (i > 0) EXPECT_EQ(buckets,c.bucket_count());  //空表没有可搬的
+            ASSERT_TRUE(c.__hashtable_verify());
+            ASSERT_EQ(size_t(i),c.size());
+        }
+        throwing_key::fail = false;
+        c.insert_unique(throwing_key(i));
+    }
+    EXPECT_TRUE(c.__hashtable_verify());
+}
+
+TEST(UnorderedMapTest,testRandomOps){
+    unordered_map<int, int, collide_hash> m;
+    std::unordered_map<int, int> ref;
+    srand(11);
+    for (int i = 0; i < 20000; ++i) {
+        int k = rand() % 200;
+        if (rand() % 2)
+            EXPECT_EQ(ref.insert(std::make_pair(k, i)).second,
+                      m.insert(std::make_pair(k, i)).second);
+        else
+            EXPECT_EQ(ref.erase(k),m.erase(k));
+    }
+    ASSERT_EQ(ref.size(),m.size());
+    for (std::unordered_map<int, int>::iterator it = ref.begin();
+         it != ref.end(); ++it)
+        EXPECT_EQ(it->second,m[it->first]);
+
+    unordered_map<int, int, collide_hash> c(m);
+    EXPECT_TRUE(c == m);
+    c[1000] = 1;
+    EXPECT_TRUE(c != m);
+}
+
+TEST(UnorderedMapTest,testLoadFactor){
+    unordered_set<int> s;
+    s.max_load_factor(0.5f);
+    s.reserve(1000);
+    size_t buckets = s.bucket_count();
+    EXPECT_GE(buckets * 0.5,1000);
+    int i = 0;
+    while (s.size() < size_t(buckets * 0.5)) s.insert(i++);
+    EXPECT_EQ(buckets,s.bucket_count());  //没超过负载因子，不会重新散列
+    s.insert(i);
+    EXPECT_LT(buckets,s.bucket_count());
+    EXPECT_LE(s.load_factor(),0.5f);
+
+    //反复插入删除不会让表无限增长
+    unordered_set<int> t;
+    for (int i = 0; i < 100000; ++i) {
+        t.insert(i);
+        if (i >= 10) t.erase(i - 10);
+    }
+    EXPECT_EQ(10u,t.size());
+    EXPECT_GE(64u,t.bucket_count());
+    int a[] = {3, 1, 4, 1, 5, 9, 2, 6};
+    int b[] = {6, 2, 9, 5, 1, 4, 3};
+    unordered_set<int> x(a, a + 8), y(b, b + 7);
+    EXPECT_EQ(7u,x.size());
+    EXPECT_TRUE(x == y);
+    y.erase(9);
+    EXPECT_FALSE(x == y);
+    x.clear();
+    EXPECT_TRUE(x.empty() && x.begin() == x.end());
+}
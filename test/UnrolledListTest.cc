@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../UnrolledList.h"
+
+using namespace TinySTL;
+
+TEST(UnrolledListTest,testPush_back){
+    unrolled_list<int, 4> v;
+    for (int i = 0; i < 10; ++i) v.push_back(i);
+
+    EXPECT_EQ(10u,v.size());
+    EXPECT_EQ(0,v.front());
+    EXPECT_EQ(9,v.back());
+    int expect = 0;
+    for (unrolled_list<int, 4>::iterator it = v.begin(); it != v.end(); ++it)
+        EXPECT_EQ(expect++,*it);
+}
+
+TEST(UnrolledListTest,testInsertErase){
+    unrolled_list<int, 4> v;
+    for (int i = 0; i < 8; ++i) v.push_back(i * 2);
+    unrolled_list<int, 4>::iterator it = v.begin();
+    for (int i = 0; i < 8; ++i) {
+        ++it;
+        it = v.insert(it, i * 2 + 1);
+        ++it;
+    }
+    int expect = 0;
+    for (it = v.begin(); it != v.end(); ++it) EXPECT_EQ(expect++,*it);
+
+    it = v.begin();
+    while (it != v.end()) {
+        it = v.erase(it);
+        if (it != v.end()) ++it;
+    }
+    EXPECT_EQ(8u,v.size());
+    expect = 1;
+    for (it = v.begin(); it != v.end(); ++it, expect += 2) EXPECT_EQ(expect,*it);
+}
+
+TEST(UnrolledListTest,testSplice){
+    unrolled_list<int, 4> a, b;
+    for (int i = 0; i < 6; ++i) a.push_back(i);
+    for (int i = 10; i < 16; ++i) b.push_back(i);
+    unrolled_list<int, 4>::iterator pos = a.begin();
+    ++pos;
+    unrolled_list<int, 4>::iterator first = b.begin();
+    ++first;
+    a.splice(pos, b, first, b.end());
+
+    EXPECT_EQ(11u,a.size());
+    EXPECT_EQ(1u,b.size());
+    int expect[] = {0, 11, 12, 13, 14, 15, 1, 2, 3, 4, 5};
+    int i = 0;
+    for (unrolled_list<int, 4>::iterator it = a.begin(); it != a.end(); ++it)
+        EXPECT_EQ(expect[i++],*it);
+}
+
+TEST(UnrolledListTest,testStrings){
+    //元素类型在std中，节点分裂、复制和合并都要走TinySTL自己的函数
+    unrolled_list<std::string> u;
+    for (int i = 0; i < 100; ++i) u.push_back("z");
+    u.insert(u.begin(), "w");  //头节点满了，分裂
+    EXPECT_EQ(101u,u.size());
+    EXPECT_EQ("w",u.front());
+
+    unrolled_list<std::string> c(u);
+    EXPECT_EQ(101u,c.size());
+    unrolled_list<std::string>::iterator it = c.begin();
+    while (it != c.end()) {  //隔一个删一个，相邻的空节点会合并
+        it = c.erase(it);
+        if (it != c.end()) ++it;
+    }
+    EXPECT_EQ(50u,c.size());
+    for (it = c.begin(); it != c.end(); ++it) EXPECT_EQ("z",*it);
+    EXPECT_EQ("w",u.front());
+}
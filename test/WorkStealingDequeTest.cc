@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../WorkStealingDeque.h"
+
+using namespace TinySTL;
+
+TEST(WorkStealingDequeTest,testOwnerAndThief){
+    work_stealing_deque<long> q(4);
+    for (long i = 0; i < 10; ++i) q.push(i);  //扩容两次
+    EXPECT_EQ(16u,q.capacity());
+    EXPECT_EQ(10u,q.size());
+
+    long x;
+    EXPECT_TRUE(q.pop(x));
+    EXPECT_EQ(9,x);
+    EXPECT_TRUE(q.steal(x));
+    EXPECT_EQ(0,x);
+    while (q.pop(x)) {
+    }
+    EXPECT_EQ(1,x);
+    EXPECT_FALSE(q.steal(x));
+    EXPECT_TRUE(q.empty());
+}
+
+//拥有者不断push并偶尔pop，多个窃取者同时steal，每个元素恰好被取走一次
+TEST(WorkStealingDequeTest,testStress){
+    const long n = 200000;
+    const int thieves = 4;
+    work_stealing_deque<long> q(8);
+    std::vector<std::atomic<int> > seen(n);
+    for (long i = 0; i < n; ++i) seen[i] = 0;
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> pool;
+    for (int k = 0; k < thieves; ++k)
+        pool.push_back(std::thread([&] {
+            long x;
+            while (!done.load() || !q.empty())
+                if (q.steal(x))
+                    ++seen[x];
+                else
+                    std::this_thread::yield();
+        }));
+
+    long x;
+    for (long i = 0; i < n; ++i) {
+        q.push(i);
+        if (i % 3 == 0 && q.pop(x)) ++seen[x];
+    }
+    while (q.pop(x)) ++seen[x];
+    done = true;
+    for (int k = 0; k < thieves; ++k) pool[k].join();
+
+    long bad = 0;
+    for (long i = 0; i < n; ++i) bad += seen[i] != 1;
+    EXPECT_EQ(0,bad);
+}